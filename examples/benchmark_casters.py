@@ -0,0 +1,64 @@
+'''
+Measures the calls per second of functions taking and returning small
+vectors (ImVec2, ImVec4, ImPlotPoint), once through the array_like
+conversion and numpy array results (before), and once through the
+direct tuple, list and array reads with tuple results (after).
+
+Needs a build configured with -DIMVIZ_BENCHMARK_HOOKS=ON, release builds
+do not have the private hooks it calls.
+'''
+
+import time
+
+import numpy as np
+
+import imviz as viz
+
+# private helpers are not part of imviz' star import
+import cppimviz
+
+
+def calls_per_second(func, arg, duration=0.5):
+
+	calls = 0
+	start = time.perf_counter()
+	end = start + duration
+
+	while time.perf_counter() < end:
+		for _ in range(1000):
+			func(arg)
+		calls += 1000
+
+	return calls / (time.perf_counter() - start)
+
+
+def main():
+
+	cases = [
+		('vec2 tuple', cppimviz._echo_vec2, (1.0, 2.0)),
+		('vec2 list', cppimviz._echo_vec2, [1.0, 2.0]),
+		('vec2 array', cppimviz._echo_vec2, np.array([1.0, 2.0], dtype=np.float32)),
+		('vec4 tuple', cppimviz._echo_vec4, (0.1, 0.2, 0.3, 1.0)),
+		('vec4 array', cppimviz._echo_vec4, np.array([0.1, 0.2, 0.3, 1.0])),
+		('point tuple', cppimviz._echo_point, (1.0, 2.0)),
+	]
+
+	print(f'{"":>12} {"before":>14} {"after":>14} {"speedup":>8}')
+
+	for name, func, arg in cases:
+
+		cppimviz._set_caster_fast_paths(False)
+		viz.return_vectors_as_tuples(False)
+		before = calls_per_second(func, arg)
+
+		cppimviz._set_caster_fast_paths(True)
+		viz.return_vectors_as_tuples(True)
+		after = calls_per_second(func, arg)
+
+		print(f'{name:>12} {before / 1e6:9.2f} Mc/s {after / 1e6:9.2f} Mc/s {after / before:7.1f}x')
+
+	viz.return_vectors_as_tuples(False)
+
+
+if __name__ == '__main__':
+	main()
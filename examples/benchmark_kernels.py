@@ -0,0 +1,24 @@
+'''
+Measures the throughput of the line rendering kernels (transform, cull and
+segment normals) for every instruction set supported by this cpu.
+
+Needs a build configured with -DIMVIZ_BENCHMARK_HOOKS=ON, release builds
+do not have the private hook it calls.
+'''
+
+import imviz as viz
+
+# private helpers are not part of imviz' star import
+import cppimviz
+
+
+def main():
+
+	print(f'Selected: {viz.get_plot_kernel_isa()}')
+
+	for isa, points_per_second in cppimviz._benchmark_plot_kernels(count=1_000_000, repeat=20):
+		print(f'{isa:>8}: {points_per_second / 1e6:8.1f} Mpoints/s')
+
+
+if __name__ == '__main__':
+	main()
@@ -1,5 +1,7 @@
 #include "binding_helpers.hpp"
 
+#include <unordered_map>
+
 std::string shapeToStr(py::array& array) {
 
     std::stringstream ss;
@@ -64,92 +66,198 @@ void assertArrayShape(std::string name,
     }
 }
 
+/**
+ * Color names and hex codes, parsed once and cached afterwards.
+ */
+
+static const size_t COLOR_CACHE_SIZE = 1024;
+
+static const std::unordered_map<std::string, ImVec4> namedColors = {
+    // single char color codes
+    {"r", ImVec4(1.0, 0.0, 0.0, 1.0)},
+    {"g", ImVec4(0.0, 1.0, 0.0, 1.0)},
+    {"b", ImVec4(0.0, 0.0, 1.0, 1.0)},
+    {"y", ImVec4(1.0, 1.0, 0.0, 1.0)},
+    {"c", ImVec4(0.0, 1.0, 1.0, 1.0)},
+    {"m", ImVec4(1.0, 0.0, 1.0, 1.0)},
+    {"k", ImVec4(0.0, 0.0, 0.0, 1.0)},
+    {"w", ImVec4(1.0, 1.0, 1.0, 1.0)},
+    // full word colors
+    {"red", ImVec4(1.0, 0.0, 0.0, 1.0)},
+    {"green", ImVec4(0.0, 1.0, 0.0, 1.0)},
+    {"blue", ImVec4(0.0, 0.0, 1.0, 1.0)},
+    {"yellow", ImVec4(1.0, 1.0, 0.0, 1.0)},
+    {"cyan", ImVec4(0.0, 1.0, 1.0, 1.0)},
+    {"magenta", ImVec4(1.0, 0.0, 1.0, 1.0)},
+    {"white", ImVec4(1.0, 1.0, 1.0, 1.0)},
+    {"key", ImVec4(0.0, 0.0, 0.0, 1.0)},
+    {"black", ImVec4(0.0, 0.0, 0.0, 1.0)},
+    {"gray", ImVec4(0.5, 0.5, 0.5, 1.0)},
+    {"grey", ImVec4(0.5, 0.5, 0.5, 1.0)}
+};
+
+static std::unordered_map<std::string, ImVec4> parsedColors;
+
+static ImVec4 parseColorString(const std::string& sc) {
+
+    if (sc.size() > 1 && sc[0] == '#') {
+        // css like hex colors
+        size_t pos = 0;
+        size_t colorNumber = std::stoul(sc.substr(1), &pos, 16);
+
+        ImVec4 c(0.0, 0.0, 0.0, 1.0);
+
+        if (sc.size() == 9) {
+            // alpha 
+            c.w = (double)(colorNumber & 0xff) / 255.0;
+            colorNumber >>= 8;
+        }
+        // blue
+        c.z = (double)(colorNumber & 0xff) / 255.0;
+        colorNumber >>= 8;
+        // green
+        c.y = (double)(colorNumber & 0xff) / 255.0;
+        colorNumber >>= 8;
+        // red
+        c.x = (double)(colorNumber & 0xff) / 255.0;
+        colorNumber >>= 8;
+
+        return c;
+    }
+
+    return IMPLOT_AUTO_COL;
+}
+
+static ImVec4 interpretColorString(PyObject* str) {
+
+    Py_ssize_t size = 0;
+    const char* data = PyUnicode_AsUTF8AndSize(str, &size);
+    if (data == nullptr) {
+        throw py::error_already_set();
+    }
+
+    std::string sc(data, (size_t)size);
+
+    auto named = namedColors.find(sc);
+    if (named != namedColors.end()) {
+        return named->second;
+    }
+
+    auto parsed = parsedColors.find(sc);
+    if (parsed != parsedColors.end()) {
+        return parsed->second;
+    }
+
+    ImVec4 c = parseColorString(sc);
+
+    if (parsedColors.size() >= COLOR_CACHE_SIZE) {
+        parsedColors.clear();
+    }
+    parsedColors.emplace(std::move(sc), c);
+
+    return c;
+}
+
+static bool isNumber(PyObject* o) {
+    return PyFloat_Check(o) || PyLong_Check(o);
+}
+
+// numpy reports native byte order as '=', whichever way it was given
+static bool nativeByteOrder(const py::dtype& dtype) {
+    return dtype.byteorder() == '=';
+}
+
+// same as a float array of the given values
+static ImVec4 colorFromValues(const float* v, size_t count) {
+
+    switch (count) {
+        case 1: return ImVec4(v[0], v[0], v[0], 1.0f);
+        case 3: return ImVec4(v[0], v[1], v[2], 1.0f);
+        case 4: return ImVec4(v[0], v[1], v[2], v[3]);
+    }
+
+    return IMPLOT_AUTO_COL;
+}
+
 ImVec4 interpretColor(py::handle& color, bool* isArray) {
 
-    std::string typeName = py::str(color.attr("__class__").attr("__name__"));
+    PyObject* o = color.ptr();
 
-    if (typeName == "str") {
-        std::string sc = py::str(color);
+    if (PyUnicode_Check(o)) {
+        return interpretColorString(o);
+    } else if (PyFloat_Check(o)) {
+        float f = (float)PyFloat_AS_DOUBLE(o);
+        return ImVec4(f, f, f, 1.0f);
+    } else if (PyLong_Check(o)) {
+        int overflow = 0;
+        long v = PyLong_AsLongAndOverflow(o, &overflow);
+        float f = overflow > 0 ? 255.0f : overflow < 0 ? 0.0f : (float)std::max(0L, std::min(255L, v));
+        f /= 255.0;
+        return ImVec4(f, f, f, 1.0f);
+    }
 
-        if (sc.size() == 1) {
-            // single char color codes
-            if (sc == "r") {
-                return ImVec4(1.0, 0.0, 0.0, 1.0);
-            } else if (sc == "g") {
-                return ImVec4(0.0, 1.0, 0.0, 1.0);
-            } else if (sc == "b") {
-                return ImVec4(0.0, 0.0, 1.0, 1.0);
-            } else if (sc == "y") {
-                return ImVec4(1.0, 1.0, 0.0, 1.0);
-            } else if (sc == "c") {
-                return ImVec4(0.0, 1.0, 1.0, 1.0);
-            } else if (sc == "m") {
-                return ImVec4(1.0, 0.0, 1.0, 1.0);
-            } else if (sc == "k") {
-                return ImVec4(0.0, 0.0, 0.0, 1.0);
-            } else if (sc == "w") {
-                return ImVec4(1.0, 1.0, 1.0, 1.0);
-            }
-        } else if (sc.size() > 1) {
-            if (sc[0] == '#') {
-                // css like hex colors
-                size_t pos = 0;
-                size_t colorNumber = std::stoul(sc.substr(1), &pos, 16);
-
-                ImVec4 c(0.0, 0.0, 0.0, 1.0);
-
-                if (sc.size() == 9) {
-                    // alpha 
-                    c.w = (double)(colorNumber & 0xff) / 255.0;
-                    colorNumber >>= 8;
+    // tuples and lists of numbers, nested ones are per point colors
+    if (PyTuple_Check(o) || PyList_Check(o)) {
+        const bool tuple = PyTuple_Check(o);
+        const Py_ssize_t n = tuple ? PyTuple_GET_SIZE(o) : PyList_GET_SIZE(o);
+        if (n > 0 && n <= 4) {
+            float v[4];
+            bool numbers = true;
+            for (Py_ssize_t i = 0; i < n && numbers; ++i) {
+                PyObject* item = tuple ? PyTuple_GET_ITEM(o, i) : PyList_GET_ITEM(o, i);
+                numbers = isNumber(item);
+                if (numbers) {
+                    v[i] = (float)PyFloat_AsDouble(item);
                 }
-                // blue
-                c.z = (double)(colorNumber & 0xff) / 255.0;
-                colorNumber >>= 8;
-                // green
-                c.y = (double)(colorNumber & 0xff) / 255.0;
-                colorNumber >>= 8;
-                // red
-                c.x = (double)(colorNumber & 0xff) / 255.0;
-                colorNumber >>= 8;
-
-                return c;
-            } else {
-                // full word colors
-                if (sc == "red") {
-                    return ImVec4(1.0, 0.0, 0.0, 1.0);
-                } else if (sc == "green") {
-                    return ImVec4(0.0, 1.0, 0.0, 1.0);
-                } else if (sc == "blue") {
-                    return ImVec4(0.0, 0.0, 1.0, 1.0);
-                } else if (sc == "yellow") {
-                    return ImVec4(1.0, 1.0, 0.0, 1.0);
-                } else if (sc == "cyan") {
-                    return ImVec4(0.0, 1.0, 1.0, 1.0);
-                } else if (sc == "magenta") {
-                    return ImVec4(1.0, 0.0, 1.0, 1.0);
-                } else if (sc == "white") {
-                    return ImVec4(1.0, 1.0, 1.0, 1.0);
-                } else if (sc == "key") {
-                    return ImVec4(0.0, 0.0, 0.0, 1.0);
-                } else if (sc == "black") {
-                    return ImVec4(0.0, 0.0, 0.0, 1.0);
-                } else if (sc == "gray") {
-                    return ImVec4(0.5, 0.5, 0.5, 1.0);
-                } else if (sc == "grey") {
-                    return ImVec4(0.5, 0.5, 0.5, 1.0);
+            }
+            if (numbers) {
+                if (PyErr_Occurred()) {
+                    throw py::error_already_set();
                 }
+                return colorFromValues(v, (size_t)n);
             }
         }
+    }
 
-        return IMPLOT_AUTO_COL;
-    } else if (typeName == "float") {
-        float f = py::cast<float>(color);
-        return ImVec4(f, f, f, 1.0f);
-    } else if (typeName == "int") { 
-        float f = std::max(0, std::min(255, py::cast<int>(color)));
-        f /= 255.0;
-        return ImVec4(f, f, f, 1.0f);
+    if (py::isinstance<py::array>(color)) {
+        py::array array = py::reinterpret_borrow<py::array>(color);
+
+        // packed RGBA per point colors
+        if (isArray != nullptr
+                && array.ndim() == 1
+                && array.dtype().kind() == 'u'
+                && array.dtype().itemsize() == 4) {
+            *isArray = true;
+            return ImVec4(1, 1, 1, 1);
+        }
+
+        // RGBA per point colors are converted by the plot, not here
+        if (isArray != nullptr && array.ndim() == 2 && array.shape(1) == 4) {
+            *isArray = true;
+            return ImVec4(1, 1, 1, 1);
+        }
+
+        // small float arrays are read in place
+        if (array.ndim() == 1
+                && array.dtype().kind() == 'f'
+                && array.shape(0) <= 4
+                && nativeByteOrder(array.dtype())) {
+            const char* data = (const char*)array.data();
+            const py::ssize_t stride = array.strides(0);
+            const size_t n = (size_t)array.shape(0);
+            float v[4];
+            if (array.dtype().itemsize() == 4) {
+                for (size_t i = 0; i < n; ++i) {
+                    v[i] = *(const float*)(data + (py::ssize_t)i * stride);
+                }
+                return colorFromValues(v, n);
+            } else if (array.dtype().itemsize() == 8) {
+                for (size_t i = 0; i < n; ++i) {
+                    v[i] = (float)*(const double*)(data + (py::ssize_t)i * stride);
+                }
+                return colorFromValues(v, n);
+            }
+        }
     }
 
     array_like<float> colorArray = array_like<float>::ensure(color);
@@ -161,27 +269,207 @@ ImVec4 interpretColor(py::handle& color, bool* isArray) {
         return ImVec4(1, 1, 1, 1);
     }
 
-    ImVec4 c(0, 0, 0, 1);
-    size_t colorLength = colorArray.shape()[0];
-
-    if (colorLength == 1) {
-        c.x = colorArray.data()[0];
-        c.y = colorArray.data()[0];
-        c.z = colorArray.data()[0];
-    } else if (colorLength == 3) {
-        c.x = colorArray.data()[0];
-        c.y = colorArray.data()[1];
-        c.z = colorArray.data()[2];
-    } else if (colorLength == 4) {
-        c.x = colorArray.data()[0];
-        c.y = colorArray.data()[1];
-        c.z = colorArray.data()[2];
-        c.w = colorArray.data()[3];
-    } else {
-        c = IMPLOT_AUTO_COL;
+    return colorFromValues(colorArray.data(), (size_t)colorArray.shape()[0]);
+}
+
+static bool tupleVectors = false;
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+static bool casterFastPaths = true;
+#endif
+
+bool loadSmallVector(py::handle src, double* out, int n) {
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+    if (!casterFastPaths) {
+        return false;
     }
+#endif
 
-    return c;
+    PyObject* o = src.ptr();
+
+    if (PyTuple_Check(o) || PyList_Check(o)) {
+        const bool tuple = PyTuple_Check(o);
+        const Py_ssize_t size = tuple ? PyTuple_GET_SIZE(o) : PyList_GET_SIZE(o);
+        if (size != n) {
+            return false;
+        }
+        for (int i = 0; i < n; ++i) {
+            PyObject* item = tuple ? PyTuple_GET_ITEM(o, i) : PyList_GET_ITEM(o, i);
+            if (PyFloat_Check(item)) {
+                out[i] = PyFloat_AS_DOUBLE(item);
+            } else if (PyLong_Check(item)) {
+                out[i] = PyLong_AsDouble(item);
+                if (out[i] == -1.0 && PyErr_Occurred()) {
+                    PyErr_Clear();
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (py::isinstance<py::array>(src)) {
+        py::array array = py::reinterpret_borrow<py::array>(src);
+        if (array.ndim() != 1
+                || array.shape(0) != n
+                || array.dtype().kind() != 'f'
+                || !nativeByteOrder(array.dtype())) {
+            return false;
+        }
+        const char* data = (const char*)array.data();
+        const py::ssize_t stride = array.strides(0);
+        if (array.dtype().itemsize() == 4) {
+            for (int i = 0; i < n; ++i) {
+                out[i] = *(const float*)(data + (py::ssize_t)i * stride);
+            }
+            return true;
+        } else if (array.dtype().itemsize() == 8) {
+            for (int i = 0; i < n; ++i) {
+                out[i] = *(const double*)(data + (py::ssize_t)i * stride);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+py::handle castSmallVector(const double* values, int n) {
+
+    PyObject* tuple = PyTuple_New(n);
+    if (tuple == nullptr) {
+        return py::handle();
+    }
+
+    for (int i = 0; i < n; ++i) {
+        PyObject* item = PyFloat_FromDouble(values[i]);
+        if (item == nullptr) {
+            Py_DECREF(tuple);
+            return py::handle();
+        }
+        PyTuple_SET_ITEM(tuple, i, item);
+    }
+
+    return py::handle(tuple);
+}
+
+void setVectorsAsTuples(bool enabled) {
+
+    tupleVectors = enabled;
+}
+
+bool vectorsAsTuples() {
+
+    return tupleVectors;
+}
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+void setCasterFastPaths(bool enabled) {
+
+    casterFastPaths = enabled;
+}
+#endif
+
+PlotFormat interpretFormat(const std::string& fmt) {
+
+    PlotFormat f;
+
+    bool lineStyle = false;
+    bool markerStyle = false;
+    bool colorStyle = false;
+
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        char c = fmt[i];
+        switch (c) {
+            // line styles, dashes are drawn as solid lines
+            case '-':
+                if (i + 1 < fmt.size() && (fmt[i + 1] == '-' || fmt[i + 1] == '.')) {
+                    i += 1;
+                }
+                lineStyle = true;
+                break;
+            case ':':
+                lineStyle = true;
+                break;
+            // markers, mapped to the closest implot marker
+            case '.': case ',': case 'o': case '8': case 'p': case 'h': case 'H':
+                f.marker = ImPlotMarker_Circle;
+                markerStyle = true;
+                break;
+            case 's':
+                f.marker = ImPlotMarker_Square;
+                markerStyle = true;
+                break;
+            case 'D': case 'd':
+                f.marker = ImPlotMarker_Diamond;
+                markerStyle = true;
+                break;
+            case '^': case '2':
+                f.marker = ImPlotMarker_Up;
+                markerStyle = true;
+                break;
+            case 'v': case '1':
+                f.marker = ImPlotMarker_Down;
+                markerStyle = true;
+                break;
+            case '<': case '3':
+                f.marker = ImPlotMarker_Left;
+                markerStyle = true;
+                break;
+            case '>': case '4':
+                f.marker = ImPlotMarker_Right;
+                markerStyle = true;
+                break;
+            case '+': case 'P': case '|': case '_':
+                f.marker = ImPlotMarker_Plus;
+                markerStyle = true;
+                break;
+            case 'x': case 'X':
+                f.marker = ImPlotMarker_Cross;
+                markerStyle = true;
+                break;
+            case '*':
+                f.marker = ImPlotMarker_Asterisk;
+                markerStyle = true;
+                break;
+            // single char color codes
+            case 'r': f.color = ImVec4(1.0, 0.0, 0.0, 1.0); colorStyle = true; break;
+            case 'g': f.color = ImVec4(0.0, 1.0, 0.0, 1.0); colorStyle = true; break;
+            case 'b': f.color = ImVec4(0.0, 0.0, 1.0, 1.0); colorStyle = true; break;
+            case 'y': f.color = ImVec4(1.0, 1.0, 0.0, 1.0); colorStyle = true; break;
+            case 'c': f.color = ImVec4(0.0, 1.0, 1.0, 1.0); colorStyle = true; break;
+            case 'm': f.color = ImVec4(1.0, 0.0, 1.0, 1.0); colorStyle = true; break;
+            case 'k': f.color = ImVec4(0.0, 0.0, 0.0, 1.0); colorStyle = true; break;
+            case 'w': f.color = ImVec4(1.0, 1.0, 1.0, 1.0); colorStyle = true; break;
+            // colors of the current colormap, e.g. "C1"
+            case 'C': {
+                int index = 0;
+                size_t digits = 0;
+                while (i + 1 < fmt.size() && fmt[i + 1] >= '0' && fmt[i + 1] <= '9') {
+                    index = 10 * index + (fmt[i + 1] - '0');
+                    digits += 1;
+                    i += 1;
+                }
+                if (digits > 0) {
+                    f.color = ImPlot::GetColormapColor(index);
+                    colorStyle = true;
+                }
+                break;
+            }
+            // anything else is skipped, like the previous regex parser did,
+            // so that existing format strings keep working
+            default:
+                break;
+        }
+    }
+
+    // like matplotlib, a bare color draws a line
+    f.line = lineStyle || (colorStyle && !markerStyle);
+
+    return f;
 }
 
 ImageInfo interpretImage(py::array& image) {
@@ -301,38 +589,172 @@ GLuint uploadImage(std::string id, ImageInfo& i, py::array& image, bool skip, bo
     return textureId;
 }
 
+/**
+ * Maps a numpy dtype to the type used to read the array in place.
+ * Returns ImGuiDataType_COUNT if the array needs to be converted.
+ */
+ImGuiDataType plotDataType(const py::dtype& dtype, double& timeScale) {
+
+    timeScale = 0.0;
+
+    const uint16_t endianTest = 1;
+    const bool littleEndian = *(const uint8_t*)&endianTest == 1;
+
+    char order = dtype.byteorder();
+    if ((order == '<' && !littleEndian) || (order == '>' && littleEndian)) {
+        return ImGuiDataType_COUNT;
+    }
+
+    char kind = dtype.kind();
+    py::ssize_t size = dtype.itemsize();
+
+    if (kind == 'f') {
+        if (size == 4) {
+            return ImGuiDataType_Float;
+        } else if (size == 8) {
+            return ImGuiDataType_Double;
+        }
+    } else if (kind == 'i') {
+        if (size == 1) {
+            return ImGuiDataType_S8;
+        } else if (size == 2) {
+            return ImGuiDataType_S16;
+        } else if (size == 4) {
+            return ImGuiDataType_S32;
+        } else if (size == 8) {
+            return ImGuiDataType_S64;
+        }
+    } else if (kind == 'u' || kind == 'b') {
+        if (size == 1) {
+            return ImGuiDataType_U8;
+        } else if (size == 2) {
+            return ImGuiDataType_U16;
+        } else if (size == 4) {
+            return ImGuiDataType_U32;
+        } else if (size == 8) {
+            return ImGuiDataType_U64;
+        }
+    } else if (kind == 'M' || kind == 'm') {
+        // unit is given as e.g. "datetime64[ns]" or "timedelta64[10ms]"
+        std::string name = py::str(dtype);
+        size_t start = name.find('[');
+        size_t end = name.find(']');
+
+        double count = 1.0;
+        std::string unit = "s";
+
+        if (start != std::string::npos && end != std::string::npos) {
+            unit = name.substr(start + 1, end - start - 1);
+            size_t unitStart = unit.find_first_not_of("0123456789");
+            if (unitStart > 0 && unitStart != std::string::npos) {
+                count = std::stod(unit.substr(0, unitStart));
+                unit = unit.substr(unitStart);
+            }
+        }
+
+        static const std::unordered_map<std::string, double> unitScales = {
+            {"Y", 31556952.0},
+            {"M", 2629746.0},
+            {"W", 604800.0},
+            {"D", 86400.0},
+            {"h", 3600.0},
+            {"m", 60.0},
+            {"s", 1.0},
+            {"ms", 1e-3},
+            {"us", 1e-6},
+            {"ns", 1e-9},
+            {"ps", 1e-12},
+            {"fs", 1e-15},
+            {"as", 1e-18},
+        };
+
+        auto it = unitScales.find(unit);
+        if (it != unitScales.end()) {
+            timeScale = count * it->second;
+            return ImGuiDataType_S64;
+        }
+    }
+
+    return ImGuiDataType_COUNT;
+}
+
+py::array toPlotArray(py::handle& data) {
+
+    py::array array = py::array::ensure(data);
+
+    if (!array) {
+        throw std::runtime_error(
+                "Plot data of type "
+                + std::string(py::str(data.get_type()))
+                + " cannot be interpreted as array");
+    }
+
+    return array;
+}
+
+PlotArray interpretPlotArray(py::array& array) {
+
+    double timeScale = 0.0;
+    ImGuiDataType type = plotDataType(array.dtype(), timeScale);
+
+    if (type == ImGuiDataType_COUNT) {
+        array = array_like<double>::ensure(array);
+        type = ImGuiDataType_Double;
+        timeScale = 0.0;
+    }
+
+    PlotArray info;
+    info.data = array.data();
+    info.type = type;
+    info.stride = array.ndim() > 0 ? (int)array.strides(array.ndim() - 1) : 0;
+    info.timeScale = timeScale;
+
+    return info;
+}
+
 PlotArrayInfo interpretPlotArrays(
-        array_like<double>& x,
-        array_like<double>& y) {
+        py::array& x,
+        py::array& y,
+        double x0,
+        double dx) {
 
     PlotArrayInfo info;
 
+    PlotArray xInfo = interpretPlotArray(x);
+    PlotArray yInfo = interpretPlotArray(y);
+
     size_t yCount = y.shape()[0];
 
     if (1 == x.ndim() && 0 == yCount) {
         // one 1d array given
-        // assume x is [0, 1, 2, ..., N]
+        // assume x is [x0, x0 + dx, x0 + 2 * dx, ..., x0 + N * dx]
         info.count = x.shape()[0];
-        info.indices.resize(info.count);
-        for (size_t i = 0; i < info.count; ++i) {
-            info.indices[i] = i;
-        }
-        info.xDataPtr = info.indices.data();
-        info.yDataPtr = x.data();
+        info.linearX = true;
+        info.x0 = x0;
+        info.dx = dx;
+        info.xSorted = dx > 0.0;
+        info.y = xInfo;
     } else if (2 == x.ndim() && 0 == yCount) {
-        // one 2d array given
+        // one 2d array given, either as (2, N) rows or (N, 2) points
         size_t len0 = x.shape()[0];
         size_t len1 = x.shape()[1];
         if (len0 == 2) {
-            info.xDataPtr = x.data();
-            info.yDataPtr = x.data() + len1;
+            info.x = xInfo;
+            info.y = xInfo;
+            info.y.data = (const uint8_t*)x.data() + x.strides(0);
             info.count = len1;
+        } else if (len1 == 2) {
+            info.x = xInfo;
+            info.x.stride = (int)x.strides(0);
+            info.y = info.x;
+            info.y.data = (const uint8_t*)x.data() + x.strides(1);
+            info.count = len0;
         }
     } else if (1 == x.ndim() && 1 == y.ndim()) {
         // two 2d arrays given
         info.count = std::min(x.shape()[0], y.shape()[0]);
-        info.xDataPtr = x.data();
-        info.yDataPtr = y.data();
+        info.x = xInfo;
+        info.y = yInfo;
     } else {
         throw std::runtime_error(
                 "Plot data with x-shape "
@@ -344,3 +766,46 @@ PlotArrayInfo interpretPlotArrays(
 
     return info;
 }
+
+PlotArrayInfo interpretPlotRows(
+        py::array& x,
+        py::array& y,
+        double x0,
+        double dx,
+        size_t& rows,
+        ptrdiff_t& rowStride) {
+
+    PlotArrayInfo info;
+
+    // only Y given, x is implicitly linear
+    bool linearX = 0 == y.ndim() || 0 == y.shape()[0];
+    py::array& ys = linearX ? x : y;
+
+    if (ys.ndim() < 1 || ys.ndim() > 2 || (!linearX && 1 != x.ndim())) {
+        throw std::runtime_error(
+                "Plot data with x-shape "
+                + shapeToStr(x)
+                + " and y-shape "
+                + shapeToStr(y)
+                + " cannot be interpreted as rows");
+    }
+
+    info.y = interpretPlotArray(ys);
+
+    size_t len = ys.shape()[ys.ndim() - 1];
+    rows = 2 == ys.ndim() ? ys.shape()[0] : 1;
+    rowStride = 2 == ys.ndim() ? ys.strides(0) : 0;
+
+    if (linearX) {
+        info.count = len;
+        info.linearX = true;
+        info.x0 = x0;
+        info.dx = dx;
+        info.xSorted = dx > 0.0;
+    } else {
+        info.x = interpretPlotArray(x);
+        info.count = std::min((size_t)x.shape()[0], len);
+    }
+
+    return info;
+}
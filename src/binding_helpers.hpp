@@ -28,6 +28,18 @@ void assertArrayShape(std::string name,
 
 ImVec4 interpretColor(py::handle& color, bool* isArray = nullptr);
 
+/**
+ * Style given by a matplotlib like format string, e.g. "r--o".
+ */
+struct PlotFormat {
+
+    bool line = false;
+    ImPlotMarker marker = ImPlotMarker_None;
+    ImVec4 color = IMPLOT_AUTO_COL;
+};
+
+PlotFormat interpretFormat(const std::string& fmt);
+
 struct ImageInfo {
 
     int imageWidth = 0;
@@ -41,17 +53,86 @@ ImageInfo interpretImage(py::array& image);
 
 GLuint uploadImage(std::string id, ImageInfo& i, py::array& image, bool skip = false, bool lerp = false);
 
+/**
+ * One dimensional view into the buffer of a numpy array.
+ *
+ * The data is read in its native type and with its native stride,
+ * so plotting does not need to convert or copy anything.
+ * The stride is given in bytes and may be negative (e.g. for a[::-1]).
+ */
+struct PlotArray {
+
+    const void* data = nullptr;
+    ImGuiDataType type = ImGuiDataType_Double;
+    int stride = sizeof(double);
+
+    // datetime64/timedelta64 values are read as int64 and scaled to seconds
+    double timeScale = 0.0;
+};
+
 struct PlotArrayInfo {
 
-    std::vector<double> indices;
-    const double* xDataPtr = nullptr;
-    const double* yDataPtr = nullptr;
+    PlotArray x;
+    PlotArray y;
     size_t count = 0;
+
+    // if only y is given, x is implicitly x0 + i * dx
+    bool linearX = false;
+    double x0 = 0.0;
+    double dx = 1.0;
+
+    // x is known to be in ascending order
+    bool xSorted = false;
+
+    // bounds of the finite samples, if already known
+    bool hasBounds = false;
+    ImPlotRect bounds;
 };
 
+ImGuiDataType plotDataType(const py::dtype& dtype, double& timeScale);
+
+py::array toPlotArray(py::handle& data);
+
+PlotArray interpretPlotArray(py::array& array);
+
 PlotArrayInfo interpretPlotArrays(
-        array_like<double>& x,
-        array_like<double>& y);
+        py::array& x,
+        py::array& y,
+        double x0 = 0.0,
+        double dx = 1.0);
+
+/**
+ * Interprets y as rows of samples sharing the same x (or an implicit
+ * linear x if only one array is given). Returns the info of the first
+ * row, row i starts i * rowStride bytes after it.
+ */
+PlotArrayInfo interpretPlotRows(
+        py::array& x,
+        py::array& y,
+        double x0,
+        double dx,
+        size_t& rows,
+        ptrdiff_t& rowStride);
+
+/**
+ * Allocation free conversion of small vectors for the type casters below.
+ * Tuples and lists of n numbers and one dimensional float arrays of
+ * length n are read directly. Returns false for anything else, which
+ * then takes the array_like path.
+ */
+bool loadSmallVector(py::handle src, double* out, int n);
+
+// returns the values as a tuple of floats
+py::handle castSmallVector(const double* values, int n);
+
+// small vectors are returned as tuples instead of numpy arrays
+void setVectorsAsTuples(bool enabled);
+bool vectorsAsTuples();
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+// disables loadSmallVector(), to compare against the array_like path
+void setCasterFastPaths(bool enabled);
+#endif
 
 /*
  * Custom type-casters
@@ -71,6 +152,13 @@ namespace pybind11 {
 
             bool load(handle src, bool) {
 
+                double v[2];
+                if (loadSmallVector(src, v, 2)) {
+                    value.x = (float)v[0];
+                    value.y = (float)v[1];
+                    return true;
+                }
+
                 auto array = array_like<float>::ensure(src);
 
                 assert_shape(array, {{2,}});
@@ -86,6 +174,11 @@ namespace pybind11 {
                     return_value_policy policy,
                     handle parent) {
 
+                if (vectorsAsTuples()) {
+                    const double v[2] = {src.x, src.y};
+                    return castSmallVector(v, 2);
+                }
+
                 if (return_value_policy::copy == policy) {
                     pybind11::array_t<float> array(2, (float*)(&src));
                     return array.release();
@@ -103,6 +196,13 @@ namespace pybind11 {
 
             bool load(handle src, bool) {
 
+                double v[2];
+                if (loadSmallVector(src, v, 2)) {
+                    value.x = (double)v[0];
+                    value.y = (double)v[1];
+                    return true;
+                }
+
                 auto array = array_like<double>::ensure(src);
 
                 assert_shape(array, {{2,}});
@@ -118,6 +218,11 @@ namespace pybind11 {
                     return_value_policy policy,
                     handle parent) {
 
+                if (vectorsAsTuples()) {
+                    const double v[2] = {src.x, src.y};
+                    return castSmallVector(v, 2);
+                }
+
                 if (return_value_policy::copy == policy) {
                     pybind11::array_t<double> array(2, (double*)(&src));
                     return array.release();
@@ -135,6 +240,13 @@ namespace pybind11 {
 
             bool load(handle src, bool) {
 
+                double v[2];
+                if (loadSmallVector(src, v, 2)) {
+                    value.Min = (double)v[0];
+                    value.Max = (double)v[1];
+                    return true;
+                }
+
                 auto array = array_like<double>::ensure(src);
 
                 assert_shape(array, {{2,}});
@@ -150,6 +262,11 @@ namespace pybind11 {
                     return_value_policy policy,
                     handle parent) {
 
+                if (vectorsAsTuples()) {
+                    const double v[2] = {src.Min, src.Max};
+                    return castSmallVector(v, 2);
+                }
+
                 if (return_value_policy::copy == policy) {
                     pybind11::array_t<double> array(2, (double*)(&src));
                     return array.release();
@@ -167,6 +284,15 @@ namespace pybind11 {
 
             bool load(handle src, bool) {
 
+                double v[4];
+                if (loadSmallVector(src, v, 4)) {
+                    value.x = (float)v[0];
+                    value.y = (float)v[1];
+                    value.z = (float)v[2];
+                    value.w = (float)v[3];
+                    return true;
+                }
+
                 auto array = array_like<float>::ensure(src);
 
                 assert_shape(array, {{4,}});
@@ -184,6 +310,11 @@ namespace pybind11 {
                     return_value_policy policy,
                     handle parent) {
 
+                if (vectorsAsTuples()) {
+                    const double v[4] = {src.x, src.y, src.z, src.w};
+                    return castSmallVector(v, 4);
+                }
+
                 if (return_value_policy::copy == policy) {
                     pybind11::array_t<float> array(4, (float*)(&src));
                     return array.release();
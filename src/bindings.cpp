@@ -158,6 +158,31 @@ PYBIND11_MODULE(cppimviz, m) {
 	)raw"
 	);
 
+	/**
+	 * Small vector conversion
+	 */
+
+	m.def("return_vectors_as_tuples", [&](bool enabled) {
+		setVectorsAsTuples(enabled);
+	},
+	R"raw(
+	Makes functions returning 2D and 4D vectors (positions, sizes, colors,
+	plot points and ranges) return tuples instead of numpy arrays.
+	Tuples are considerably cheaper to create for single values.
+	)raw",
+	py::arg("enabled") = true);
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+	m.def("_set_caster_fast_paths", [&](bool enabled) {
+		setCasterFastPaths(enabled);
+	},
+	py::arg("enabled") = true);
+
+	m.def("_echo_vec2", [&](ImVec2 v) { return v; }, py::arg("v"));
+	m.def("_echo_vec4", [&](ImVec4 v) { return v; }, py::arg("v"));
+	m.def("_echo_point", [&](ImPlotPoint v) { return v; }, py::arg("v"));
+#endif
+
 	/**
 	 * Custom widgets
 	 */
@@ -6,6 +6,9 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 
+#include <algorithm>
+#include <array>
+
 #include <pybind11/pytypes.h>
 #include <pybind11/stl.h>
 
@@ -13,7 +16,96 @@
 #include "implot.h"
 #include "implot_internal.h"
 #include "implot_ext.hpp"
+#include "heatmap.hpp"
+#include "simd_kernels.hpp"
+
+
+/**
+ * Plot data of a query, either arrays like in plot() or a series handle.
+ * LodSeries and PlotSeries are versioned by the generation of the series,
+ * which only changes with their samples. A StreamSeries is queried on a
+ * copy of its current samples, which is never versioned.
+ */
+static PlotArrayInfo interpretSeries(py::handle x,
+                                     py::handle y,
+                                     double x0,
+                                     double dx,
+                                     bool xSorted,
+                                     py::array& xArray,
+                                     py::array& yArray,
+                                     int64_t& dataVersion) {
+
+    if (py::isinstance<LodSeries>(x)) {
+        LodSeries& lod = x.cast<LodSeries&>();
+        dataVersion = lod.generation;
+        return lod.pai;
+    }
+
+    if (py::isinstance<PlotSeries>(x)) {
+        PlotSeries& series = x.cast<PlotSeries&>();
+        xArray = series.xArray;
+        yArray = series.yArray;
+        dataVersion = series.generation;
+        return series.pai;
+    }
+
+    if (py::isinstance<StreamSeries>(x)) {
+        bool sorted = false;
+        x.cast<StreamSeries&>().snapshot(xArray, yArray, sorted);
+        dataVersion = -1;
+        PlotArrayInfo pai = interpretPlotArrays(xArray, yArray, 0.0, 1.0);
+        pai.xSorted = pai.xSorted || sorted;
+        return pai;
+    }
+
+    xArray = toPlotArray(x);
+    yArray = toPlotArray(y);
+
+    PlotArrayInfo pai = interpretPlotArrays(xArray, yArray, x0, dx);
+    pai.xSorted = pai.xSorted || xSorted;
+
+    return pai;
+}
+
+/**
+ * A flat tuple or list of 1, 3 or 4 numbers, which is one color
+ * rather than a color per row.
+ */
+static bool isColorTuple(py::handle color) {
+
+    if (!py::isinstance<py::tuple>(color) && !py::isinstance<py::list>(color)) {
+        return false;
+    }
+
+    const size_t n = py::len(color);
+    if (n != 1 && n != 3 && n != 4) {
+        return false;
+    }
+
+    for (py::handle c : color) {
+        if (!PyNumber_Check(c.ptr()) || py::isinstance<py::array>(c)) {
+            return false;
+        }
+    }
+
+    return true;
+}
 
+/**
+ * Whether an optional array argument like shade is empty, without
+ * converting (and possibly copying) the whole array to find out.
+ */
+static bool isEmptyArray(py::handle a) {
+
+    if (a.is_none()) {
+        return true;
+    }
+    if (py::isinstance<py::array>(a)) {
+        return py::reinterpret_borrow<py::array>(a).size() == 0;
+    }
+
+    return py::len(a) == 0;
+}
 
 void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
 
@@ -60,6 +152,14 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
         .value("NONE", ImPlotBarsFlags_None)
         .value("HORIZONTAL", ImPlotBarsFlags_Horizontal);
 
+    py::enum_<ImPlotHistogramFlags_>(m, "PlotHistogramFlags", py::arithmetic())
+        .value("NONE", ImPlotHistogramFlags_None)
+        .value("HORIZONTAL", ImPlotHistogramFlags_Horizontal)
+        .value("CUMULATIVE", ImPlotHistogramFlags_Cumulative)
+        .value("DENSITY", ImPlotHistogramFlags_Density)
+        .value("NO_OUTLIERS", ImPlotHistogramFlags_NoOutliers)
+        .value("COL_MAJOR", ImPlotHistogramFlags_ColMajor);
+
     py::enum_<ImPlotImageFlags_>(m, "PlotImageFlags", py::arithmetic())
         .value("NONE", ImPlotImageFlags_None);
 
@@ -382,88 +482,258 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
     },
     py::arg("count") = 1);
 
-    m.def("plot", [&](array_like<double> x,
-                      array_like<double> y,
+    py::class_<StreamSeries>(m, "StreamSeries")
+        .def(py::init([](size_t capacity, py::object dtype, bool wake) {
+            return new StreamSeries(capacity, py::dtype::from_args(dtype), wake);
+        }),
+        py::arg("capacity"),
+        py::arg("dtype") = py::dtype::of<double>(),
+        py::arg("wake") = false)
+        .def("append", [&](StreamSeries& stream, py::handle x, py::handle y) {
+            stream.append(x, y);
+            if (stream.wake) {
+                viz.trigger();
+            }
+        },
+        py::arg("x"),
+        py::arg("y"))
+        .def("clear", &StreamSeries::clear)
+        .def("__len__", &StreamSeries::size)
+        .def_readonly("capacity", &StreamSeries::capacity)
+        .def_readwrite("wake", &StreamSeries::wake);
+
+    py::class_<LodSeries>(m, "LodSeries")
+        .def(py::init<py::handle, py::handle, double, double>(),
+        py::arg("x"),
+        py::arg("y") = py::array(),
+        py::arg("x0") = 0.0,
+        py::arg("dx") = 1.0)
+        .def_property_readonly("ready", [](LodSeries& lod) {
+            return lod.ready.load();
+        })
+        .def("__len__", [](LodSeries& lod) {
+            return lod.pai.count;
+        });
+
+    py::class_<PlotSeries>(m, "PlotSeries")
+        .def(py::init<py::handle,
+                      py::handle,
+                      const std::string&,
+                      const std::string&,
+                      py::handle,
+                      float,
+                      float,
+                      float,
+                      ImPlotLineFlags,
+                      bool,
+                      double,
+                      double,
+                      bool,
+                      py::handle,
+                      py::handle,
+                      ImPlotColormap,
+                      std::optional<double>,
+                      std::optional<double>,
+                      py::handle>(),
+        py::arg("x"),
+        py::arg("y") = py::array(),
+        py::arg("fmt") = "-",
+        py::arg("label") = "",
+        py::arg("color") = py::array(),
+        py::arg("line_weight") = 1.0f,
+        py::arg("marker_size") = 4.0f,
+        py::arg("marker_weight") = 1.0f,
+        py::arg("flags") = ImPlotLineFlags_None,
+        py::arg("decimate") = true,
+        py::arg("x0") = 0.0,
+        py::arg("dx") = 1.0,
+        py::arg("x_sorted") = false,
+        py::arg("color_values") = py::none(),
+        py::arg("color_index") = py::none(),
+        py::arg("colormap") = IMPLOT_AUTO,
+        py::arg("vmin") = py::none(),
+        py::arg("vmax") = py::none(),
+        py::arg("palette") = py::none())
+        .def("draw", &PlotSeries::draw)
+        .def("set_data", &PlotSeries::setData,
+        py::arg("x"),
+        py::arg("y") = py::array(),
+        py::arg("x0") = 0.0,
+        py::arg("dx") = 1.0,
+        py::arg("x_sorted") = false)
+        .def("set_style", &PlotSeries::setStyle,
+        py::arg("fmt") = "-",
+        py::arg("color") = py::array())
+        .def("invalidate", &PlotSeries::invalidate)
+        .def_readwrite("label", &PlotSeries::label)
+        .def_readwrite("line_weight", &PlotSeries::lineWeight)
+        .def_readwrite("marker_size", &PlotSeries::markerSize)
+        .def_readwrite("marker_weight", &PlotSeries::markerWeight)
+        .def_readwrite("flags", &PlotSeries::flags)
+        .def_readwrite("decimate", &PlotSeries::decimate)
+        .def("__len__", [](PlotSeries& series) {
+            return series.pai.count;
+        });
+
+    m.def("plot", [&](py::handle x,
+                      py::handle y,
                       std::string fmt,
                       std::string label,
                       py::handle color,
-                      array_like<double> shade,
+                      py::handle shadeData,
                       float shadeAlpha,
                       float lineWeight,
                       float markerSize,
                       float markerWeight,
-                      ImPlotLineFlags flags) {
+                      ImPlotLineFlags flags,
+                      bool decimate,
+                      double x0,
+                      double dx,
+                      bool xSorted,
+                      py::handle colorValues,
+                      py::handle colorIndex,
+                      ImPlotColormap colormap,
+                      std::optional<double> vmin,
+                      std::optional<double> vmax,
+                      py::handle palette,
+                      int64_t dataVersion,
+                      py::handle density,
+                      bool dedupPixels) {
 
-        // interpret data
+        // interpret marker format
 
-        PlotArrayInfo pai = interpretPlotArrays(x, y);
+        PlotFormat format = interpretFormat(fmt);
+        bool line = format.line;
+        ImPlotMarker markerStyle = format.marker;
 
-        // interpret marker format
+        // an explicit color overrides the one of the format string
+        bool isArray = false;
+        ImVec4 ic = interpretColor(color, &isArray);
+        if (ic.w < 0.0f) {
+            ic = format.color;
+        }
+
+        // set style vars
+
+        ImPlot::SetNextLineStyle(ic, lineWeight);
+        ImPlot::SetNextMarkerStyle(markerStyle, markerSize, ic, markerWeight, ic);
 
-        static std::regex re{"(-)?(o|s|d|\\*|\\+)?"};
+        // series handles are plotted straight from their own buffers
 
-        std::smatch match;
-        std::regex_search(fmt, match, re);
+        if (py::isinstance<StreamSeries>(x)) {
+            if (isArray
+                    || !colorValues.is_none()
+                    || !colorIndex.is_none()
+                    || !isEmptyArray(shadeData)) {
+                throw py::value_error(
+                        "StreamSeries are plotted with a single color and without shade");
+            }
+            ImPlot::plotStream(label.c_str(), x.cast<StreamSeries&>(), line, flags, decimate);
+            return;
+        }
 
-        std::vector<std::string> groups;
-        for (auto m : match) {
-            if (m.matched) {
-                groups.push_back(m.str());
+        // massive scatter plots are splatted into a density image, by default
+        // above a point count where markers would only overdraw each other.
+        // The image is colored by the colormap alone, so only plots without
+        // a color, per point colors, shade or dedup_pixels switch by default,
+        // density=True draws it regardless of them.
+
+        auto splat = [&](size_t count) {
+            if (!density.is_none()) {
+                return density.cast<bool>();
+            }
+            return ImPlot::shouldSplat(count)
+                && ic.w < 0.0f
+                && !isArray
+                && colorValues.is_none()
+                && colorIndex.is_none()
+                && !dedupPixels
+                && isEmptyArray(shadeData);
+        };
+
+        if (py::isinstance<LodSeries>(x)) {
+            if (isArray
+                    || !colorValues.is_none()
+                    || !colorIndex.is_none()
+                    || !isEmptyArray(shadeData)) {
+                throw py::value_error(
+                        "LodSeries are plotted with a single color and without shade");
+            }
+            if (!decimate || x0 != 0.0 || dx != 1.0 || xSorted) {
+                throw py::value_error(
+                        "LodSeries are always decimated, x0, dx and x_sorted are fixed at their creation");
+            }
+            LodSeries& lod = x.cast<LodSeries&>();
+            if (line) {
+                ImPlot::plotLod(label.c_str(), lod, flags);
+            } else if (splat(lod.pai.count)) {
+                ImPlot::plotDensity(label.c_str(), lod.pai, colormap, flags);
             } else {
-                groups.push_back("");
+                ImPlot::plotScatter(label.c_str(), lod.pai, flags, dedupPixels);
             }
+            return;
         }
 
-        ImPlotMarker markerStyle = ImPlotMarker_None;
-        if (groups[2] == "o") {
-            markerStyle = ImPlotMarker_Circle;
-        } else if (groups[2] == "s") {
-            markerStyle = ImPlotMarker_Square;
-        } else if (groups[2] == "d") {
-            markerStyle = ImPlotMarker_Diamond;
-        } else if (groups[2] == "+") {
-            markerStyle = ImPlotMarker_Cross;
-        } else if (groups[2] == "*") {
-            markerStyle = ImPlotMarker_Asterisk;
+        // interpret data
+
+        py::array xArray = toPlotArray(x);
+        py::array yArray = toPlotArray(y);
+
+        PlotArrayInfo pai = interpretPlotArrays(xArray, yArray, x0, dx);
+        pai.xSorted = pai.xSorted || xSorted;
+
+        // bounds (and sortedness) of versioned data are only scanned once
+        ImPlot::cacheBounds(pai, dataVersion);
+
+        if (!line && splat(pai.count)) {
+            ImPlot::plotDensity(label.c_str(), pai, colormap, flags);
+            return;
         }
 
-        bool isArray = false;
-        ImVec4 ic = interpretColor(color, &isArray);
+        // per point colors, mapped or packed to RGBA bytes
 
-        // set style vars
+        py::array colorArray;
+        const ImU32* pointColors = nullptr;
 
-        ImPlot::SetNextLineStyle(ic, lineWeight);
-        ImPlot::SetNextMarkerStyle(markerStyle, markerSize, ic, markerWeight, ic);
+        if (!colorValues.is_none()) {
+            pointColors = ImPlot::mapColorValues(colorValues, pai.count, colormap, vmin, vmax);
+        } else if (!colorIndex.is_none()) {
+            pointColors = ImPlot::mapColorIndices(colorIndex, pai.count, palette, colormap);
+        } else if (isArray) {
+            pointColors = ImPlot::packColors(color, pai.count, colorArray);
+        }
 
-        if (isArray) {
-            ImPlot::customPlot(label.c_str(), pai, color, groups[1] != "-", flags);
+        if (pointColors != nullptr) {
+            ImPlot::customPlot(label.c_str(), pai, pointColors, !line, flags, decimate, dedupPixels);
         } else {
             // plot lines and markers
 
-            if (groups[1] == "-") {
-                ImPlot::PlotLine(label.c_str(), pai.xDataPtr, pai.yDataPtr, pai.count, flags);
+            if (line) {
+                ImPlot::plotLine(label.c_str(), pai, flags, decimate);
             } else {
-                ImPlot::PlotScatter(label.c_str(), pai.xDataPtr, pai.yDataPtr, pai.count, flags);
+                ImPlot::plotScatter(label.c_str(), pai, flags, dedupPixels);
             }
 
-            // plot shade if needed
-
-            size_t shadeCount = std::min(pai.count, (size_t)shade.shape()[0]);
-
-            if (shadeCount != 0) {
-                if (1 == shade.ndim()) {
-                    ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, shadeAlpha);
-                    auto mean = py::cast<py::array_t<double>>(y[py::slice(0, shadeCount, 1)]);
-                    py::array_t<double> upper = mean + shade;
-                    py::array_t<double> lower = mean - shade;
-                    ImPlot::PlotShaded(label.c_str(),
-                                       pai.xDataPtr,
-                                       lower.data(),
-                                       upper.data(),
-                                       shadeCount,
-                                       flags);
-                    ImPlot::PopStyleVar();
-                }
+            // plot shade if needed, either symmetric (N) or as (2, N) lower and upper offsets
+
+            array_like<double> shade = array_like<double>::ensure(shadeData);
+
+            if (shade.size() != 0) {
+                assert_shape(shade, {{-1}, {2, -1}});
+
+                const double* lower = shade.data();
+                const double* upper = 2 == shade.ndim() ? lower + shade.shape(1) : lower;
+                size_t shadeCount = std::min(pai.count, (size_t)shade.shape(shade.ndim() - 1));
+
+                ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, shadeAlpha);
+                ImPlot::plotShaded(label.c_str(),
+                                   pai,
+                                   lower,
+                                   upper,
+                                   shadeCount,
+                                   flags,
+                                   decimate);
+                ImPlot::PopStyleVar();
             }
         }
     },
@@ -477,26 +747,134 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
     py::arg("line_weight") = 1.0f, 
     py::arg("marker_size") = 4.0f, 
     py::arg("marker_weight") = 1.0f,
-    py::arg("flags") = ImPlotLineFlags_None);
+    py::arg("flags") = ImPlotLineFlags_None,
+    py::arg("decimate") = true,
+    py::arg("x0") = 0.0,
+    py::arg("dx") = 1.0,
+    py::arg("x_sorted") = false,
+    py::arg("color_values") = py::none(),
+    py::arg("color_index") = py::none(),
+    py::arg("colormap") = IMPLOT_AUTO,
+    py::arg("vmin") = py::none(),
+    py::arg("vmax") = py::none(),
+    py::arg("palette") = py::none(),
+    py::arg("data_version") = -1,
+    py::arg("density") = py::none(),
+    py::arg("dedup_pixels") = false);
+
+    m.def("plot_many", [&](py::handle x,
+                           py::handle y,
+                           py::object labels,
+                           py::object colors,
+                           std::string fmt,
+                           float lineWeight,
+                           float markerSize,
+                           float markerWeight,
+                           ImPlotLineFlags flags,
+                           bool decimate,
+                           double x0,
+                           double dx,
+                           bool xSorted) {
+
+        PlotFormat format = interpretFormat(fmt);
+        bool line = format.line;
+        ImPlotMarker markerStyle = format.marker;
+
+        // interpret data
+
+        py::array xArray = toPlotArray(x);
+        py::array yArray = toPlotArray(y);
+
+        size_t rows = 0;
+        ptrdiff_t rowStride = 0;
+        PlotArrayInfo pai = interpretPlotRows(xArray, yArray, x0, dx, rows, rowStride);
+        pai.xSorted = pai.xSorted || xSorted;
 
-    m.def("plot_bars", [&](array_like<double> x,
-                           array_like<double> y,
+        // one legend item per row, rows without a label are not listed
+
+        std::vector<std::string> rowLabels(rows);
+
+        size_t i = 0;
+        if (py::isinstance<py::str>(labels)) {
+            std::string label = py::str(labels);
+            for (; i < rows; ++i) {
+                rowLabels[i] = label + "##" + std::to_string(i);
+            }
+        } else if (!labels.is_none()) {
+            for (py::handle l : labels) {
+                if (i >= rows) {
+                    break;
+                }
+                rowLabels[i++] = py::str(l);
+            }
+        }
+        for (; i < rows; ++i) {
+            rowLabels[i] = "##" + std::to_string(i);
+        }
+
+        // either one color for all rows or one per row (cycled)
+
+        std::vector<ImVec4> rowColors;
+
+        bool singleColor = py::isinstance<py::str>(colors)
+            || isColorTuple(colors)
+            || (py::isinstance<py::array>(colors) && 1 == colors.cast<py::array>().ndim());
+
+        if (singleColor) {
+            rowColors.push_back(interpretColor(colors));
+        } else if (!colors.is_none()) {
+            for (py::handle c : colors) {
+                rowColors.push_back(interpretColor(c));
+            }
+        }
+
+        if (rowColors.empty() && format.color.w >= 0.0f) {
+            rowColors.push_back(format.color);
+        }
+
+        ImPlot::plotMany(rowLabels,
+                         pai,
+                         rows,
+                         rowStride,
+                         rowColors,
+                         line,
+                         lineWeight,
+                         markerStyle,
+                         markerSize,
+                         markerWeight,
+                         flags,
+                         decimate);
+    },
+    py::arg("x"),
+    py::arg("y") = py::array(),
+    py::arg("labels") = py::none(),
+    py::arg("colors") = py::none(),
+    py::arg("fmt") = "-",
+    py::arg("line_weight") = 1.0f,
+    py::arg("marker_size") = 4.0f,
+    py::arg("marker_weight") = 1.0f,
+    py::arg("flags") = ImPlotLineFlags_None,
+    py::arg("decimate") = true,
+    py::arg("x0") = 0.0,
+    py::arg("dx") = 1.0,
+    py::arg("x_sorted") = false);
+
+    m.def("plot_bars", [&](py::handle x,
+                           py::handle y,
                            std::string label,
                            py::handle& color,
                            double bar_size,
                            ImPlotBarsFlags flags) {
 
-        PlotArrayInfo pai = interpretPlotArrays(x, y);
+        py::array xArray = toPlotArray(x);
+        py::array yArray = toPlotArray(y);
+
+        PlotArrayInfo pai = interpretPlotArrays(xArray, yArray);
 
         ImVec4 col = interpretColor(color);
         ImPlot::SetNextFillStyle(col);
 
-        ImPlot::PlotBars(label.c_str(),
-                         pai.xDataPtr,
-                         pai.yDataPtr,
-                         pai.count,
-                         bar_size,
-                         flags);
+        ImPlot::plotBars(label.c_str(), pai, bar_size, flags);
     },
     py::arg("x"),
     py::arg("y") = py::array(),
@@ -505,6 +883,76 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
     py::arg("bar_size") = 0.5,
     py::arg("flags") = ImPlotBarsFlags_None);
 
+    m.def("plot_histogram", [&](py::handle values,
+                                std::string label,
+                                int bins,
+                                double bar_scale,
+                                py::object range,
+                                py::handle& color,
+                                ImPlotHistogramFlags flags,
+                                int64_t dataVersion) {
+
+        py::array array = toPlotArray(values);
+        if (array.ndim() != 1) {
+            throw py::value_error("Histogram values with shape "
+                    + shapeToStr(array)
+                    + " are not one dimensional");
+        }
+        PlotArray pa = interpretPlotArray(array);
+
+        ImPlotRange r;
+        if (!range.is_none()) {
+            r = range.cast<ImPlotRange>();
+        }
+
+        ImVec4 col = interpretColor(color);
+        ImPlot::SetNextFillStyle(col);
+
+        return ImPlot::plotHistogram(
+                label.c_str(), pa, array.shape(0), bins, bar_scale, r, flags, dataVersion);
+    },
+    py::arg("values"),
+    py::arg("label") = "",
+    py::arg("bins") = (int)ImPlotBin_Sturges,
+    py::arg("bar_scale") = 1.0,
+    py::arg("range") = py::none(),
+    py::arg("color") = ImVec4(0.0f, 0.0f, 0.0f, -1.0f),
+    py::arg("flags") = ImPlotHistogramFlags_None,
+    py::arg("data_version") = -1);
+
+    m.def("plot_histogram2d", [&](py::handle x,
+                                  py::handle y,
+                                  std::string label,
+                                  int x_bins,
+                                  int y_bins,
+                                  py::object range,
+                                  ImPlotHistogramFlags flags,
+                                  int64_t dataVersion) {
+
+        py::array xArray = toPlotArray(x);
+        py::array yArray = toPlotArray(y);
+
+        PlotArrayInfo pai = interpretPlotArrays(xArray, yArray);
+
+        // same order as get_plot_selection(), defaults to the range of the data
+        ImPlotRect r;
+        if (!range.is_none()) {
+            std::array<double, 4> v = range.cast<std::array<double, 4>>();
+            r = ImPlotRect(v[0], v[2], v[1], v[3]);
+        }
+
+        return ImPlot::plotHistogram2D(
+                label.c_str(), pai, x_bins, y_bins, r, flags, dataVersion);
+    },
+    py::arg("x"),
+    py::arg("y"),
+    py::arg("label") = "",
+    py::arg("x_bins") = (int)ImPlotBin_Sturges,
+    py::arg("y_bins") = (int)ImPlotBin_Sturges,
+    py::arg("range") = py::none(),
+    py::arg("flags") = ImPlotHistogramFlags_None,
+    py::arg("data_version") = -1);
+
     m.def("plot_image", [&](
                 std::string label,
                 py::array& image,
@@ -596,6 +1044,54 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
     py::arg("tint") = ImVec4(1.0f, 1.0f, 1.0f, 1.0f),
     py::arg("flags") = ImPlotImageFlags_None);
 
+    m.def("plot_heatmap", [&](
+                std::string label,
+                py::array& values,
+                std::optional<double> vmin,
+                std::optional<double> vmax,
+                ImPlotColormap colormap,
+                double x,
+                double y,
+                double displayWidth,
+                double displayHeight,
+                bool interpolate,
+                int64_t dataVersion,
+                ImPlotItemFlags flags) {
+
+        assert_shape(values, {{-1, -1}});
+
+        if (displayWidth < 0) {
+            displayWidth = values.shape(1);
+        }
+        if (displayHeight < 0) {
+            displayHeight = values.shape(0);
+        }
+
+        ImPlot::plotHeatmap(
+                label.c_str(),
+                values,
+                vmin,
+                vmax,
+                colormap,
+                ImPlotPoint(x, y),
+                ImPlotPoint(x + displayWidth, y + displayHeight),
+                interpolate,
+                dataVersion,
+                flags);
+    },
+    py::arg("label"),
+    py::arg("values"),
+    py::arg("vmin") = py::none(),
+    py::arg("vmax") = py::none(),
+    py::arg("colormap") = IMPLOT_AUTO,
+    py::arg("x") = 0,
+    py::arg("y") = 0,
+    py::arg("width") = -1,
+    py::arg("height") = -1,
+    py::arg("interpolate") = false,
+    py::arg("data_version") = -1,
+    py::arg("flags") = ImPlotItemFlags_None);
+
     m.def("drag_point", [&](std::string label,
                             array_like<double> point,
                             py::handle color,
@@ -620,19 +1116,23 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
     py::arg("flags") = ImPlotDragToolFlags_None);
 
     m.def("plot_vlines", [&](std::string label,
-                            array_like<double> xs,
+                            py::handle xsData,
                             py::handle color,
                             float width,
                             ImPlotInfLinesFlags flags) {
 
+        py::array xs = toPlotArray(xsData);
+
         assert_shape(xs, {{-1}});
 
+        PlotArray values = interpretPlotArray(xs);
+
         flags &= ~ImPlotInfLinesFlags_Horizontal;
 
         ImVec4 c = interpretColor(color);
         ImPlot::SetNextLineStyle(c, width);
 
-        ImPlot::PlotInfLines(label.c_str(), xs.data(), xs.shape(0), flags);
+        ImPlot::plotInfLines(label.c_str(), values, xs.shape(0), flags);
     },
     py::arg("label"),
     py::arg("xs"),
@@ -641,19 +1141,23 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
     py::arg("flags") = ImPlotInfLinesFlags_None);
 
     m.def("plot_hlines", [&](std::string label,
-                            array_like<double> ys,
+                            py::handle ysData,
                             py::handle color,
                             float width,
                             ImPlotInfLinesFlags flags) {
 
+        py::array ys = toPlotArray(ysData);
+
         assert_shape(ys, {{-1}});
 
+        PlotArray values = interpretPlotArray(ys);
+
         flags |= ImPlotInfLinesFlags_Horizontal;
 
         ImVec4 c = interpretColor(color);
         ImPlot::SetNextLineStyle(c, width);
 
-        ImPlot::PlotInfLines(label.c_str(), ys.data(), ys.shape(0), flags);
+        ImPlot::plotInfLines(label.c_str(), values, ys.shape(0), flags);
     },
     py::arg("label"),
     py::arg("ys"),
@@ -934,6 +1438,106 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
         return ImPlot::GetPlotMousePos();
     });
 
+    m.def("nearest_point", [&](py::handle x,
+                               py::handle y,
+                               float pixelRadius,
+                               double x0,
+                               double dx,
+                               bool xSorted,
+                               int64_t dataVersion,
+                               ImAxis xAxis,
+                               ImAxis yAxis) -> py::object {
+
+        py::array xArray;
+        py::array yArray;
+        PlotArrayInfo pai = interpretSeries(x, y, x0, dx, xSorted, xArray, yArray, dataVersion);
+
+        int64_t index = ImPlot::nearestPoint(pai, pixelRadius, dataVersion, xAxis, yAxis);
+
+        if (index < 0) {
+            return py::none();
+        }
+        return py::int_(index);
+    },
+    py::arg("x"),
+    py::arg("y") = py::array(),
+    py::arg("pixel_radius") = 10.0f,
+    py::arg("x0") = 0.0,
+    py::arg("dx") = 1.0,
+    py::arg("x_sorted") = false,
+    py::arg("data_version") = -1,
+    py::arg("x_axis") = IMPLOT_AUTO,
+    py::arg("y_axis") = IMPLOT_AUTO);
+
+    m.def("select_in_rect", [&](py::handle x,
+                                py::handle y,
+                                py::object rect,
+                                double x0,
+                                double dx,
+                                bool xSorted,
+                                int64_t dataVersion,
+                                bool incremental) {
+
+        py::array xArray;
+        py::array yArray;
+        PlotArrayInfo pai = interpretSeries(x, y, x0, dx, xSorted, xArray, yArray, dataVersion);
+
+        // same order as get_plot_selection(), defaults to the current selection
+        ImPlotRect r;
+        if (rect.is_none()) {
+            r = ImPlot::GetPlotSelection();
+        } else {
+            std::array<double, 4> v = rect.cast<std::array<double, 4>>();
+            r = ImPlotRect(v[0], v[2], v[1], v[3]);
+        }
+
+        return ImPlot::selectInRect(pai, r, dataVersion, incremental);
+    },
+    py::arg("x"),
+    py::arg("y") = py::array(),
+    py::arg("rect") = py::none(),
+    py::arg("x0") = 0.0,
+    py::arg("dx") = 1.0,
+    py::arg("x_sorted") = false,
+    py::arg("data_version") = -1,
+    py::arg("incremental") = false);
+
+    m.def("select_in_polygon", [&](py::handle x,
+                                   py::handle y,
+                                   py::handle polygon,
+                                   double x0,
+                                   double dx,
+                                   bool xSorted) {
+
+        py::array xArray;
+        py::array yArray;
+        int64_t dataVersion = -1;
+        PlotArrayInfo pai = interpretSeries(x, y, x0, dx, xSorted, xArray, yArray, dataVersion);
+
+        if (polygon.is_none()) {
+            throw py::value_error("select_in_polygon() needs a polygon of (N, 2) points");
+        }
+
+        array_like<double> poly = array_like<double>::ensure(polygon);
+        if (!poly) {
+            throw py::error_already_set();
+        }
+        assert_shape(poly, {{-1, 2}});
+
+        std::vector<ImPlotPoint> points(poly.shape(0));
+        for (size_t i = 0; i < points.size(); ++i) {
+            points[i] = ImPlotPoint(poly.at(i, 0), poly.at(i, 1));
+        }
+
+        return ImPlot::selectInPolygon(pai, points);
+    },
+    py::arg("x"),
+    py::arg("y") = py::array(),
+    py::arg("polygon") = py::none(),
+    py::arg("x0") = 0.0,
+    py::arg("dx") = 1.0,
+    py::arg("x_sorted") = false);
+
     m.def("pixels_to_plot", [&](float x, float y, ImAxis xAxis, ImAxis yAxis) {
         ImPlotPoint point = ImPlot::PixelsToPlot(x, y, xAxis, yAxis);
         return std::vector<double>({point.x, point.y});
@@ -1056,4 +1660,26 @@ void loadImplotPythonBindings(pybind11::module& m, ImViz& viz) {
 
     #pragma endregion
 
+    #pragma region Kernels
+
+    m.def("set_plot_marker_sprites", [](bool enabled) {
+        ImPlot::setMarkerSprites(enabled);
+    },
+    py::arg("enabled") = true);
+
+    m.def("get_plot_kernel_isa", []() {
+        return std::string(kernels::isaName(kernels::currentIsa()));
+    });
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+    m.def("_benchmark_plot_kernels", [](int count, int repeat) {
+        py::gil_scoped_release release;
+        return kernels::benchmark(count, repeat);
+    },
+    py::arg("count") = 1000000,
+    py::arg("repeat") = 10);
+#endif
+
+    #pragma endregion
+
 }
@@ -0,0 +1,476 @@
+#include "heatmap.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <unordered_map>
+
+#include "imgui.h"
+#include "implot_internal.h"
+
+namespace ImPlot {
+
+/**
+ * Value textures
+ */
+
+struct ValueTexture {
+    GLuint id = 0;
+    int width = 0;
+    int height = 0;
+    GLenum datatype = 0;
+    int64_t version = -1;
+    // finite range of the data
+    double lo = 0.0;
+    double hi = 1.0;
+    // texels are normalized, value = texel * scale
+    double scale = 1.0;
+};
+
+static std::unordered_map<ImGuiID, ValueTexture> valueTextures;
+
+template <typename T>
+static void valueRange(const T* data, size_t count, double& lo, double& hi) {
+
+    lo = INFINITY;
+    hi = -INFINITY;
+    for (size_t i = 0; i < count; ++i) {
+        double v = (double)data[i];
+        if (!ImNanOrInf(v)) {
+            lo = ImMin(lo, v);
+            hi = ImMax(hi, v);
+        }
+    }
+    if (lo > hi) {
+        lo = 0.0;
+        hi = 1.0;
+    }
+}
+
+// binds the texture of id with the given filtering, creating it if needed
+static ValueTexture& bindValueTexture(ImGuiID id, bool interpolate) {
+
+    ValueTexture& tex = valueTextures[id];
+
+    if (tex.id == 0) {
+        glGenTextures(1, &tex.id);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, tex.id);
+
+    // filtering is cheap to change, the data is not
+    const GLint filter = interpolate ? GL_LINEAR : GL_NEAREST;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // grey if drawn without the heatmap shader
+    GLint swizzleMask[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+
+    return tex;
+}
+
+// uploads to the bound texture, reusing its storage if the size and type match
+static void uploadTexels(ValueTexture& tex, const void* data, int width, int height, GLenum internalFormat, GLenum datatype) {
+
+    GLint lastAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &lastAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (width == tex.width && height == tex.height && datatype == tex.datatype) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, datatype, data);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RED, datatype, data);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, lastAlignment);
+
+    tex.width = width;
+    tex.height = height;
+    tex.datatype = datatype;
+}
+
+static const ValueTexture& uploadValues(ImGuiID id, py::array& values, int64_t version, bool interpolate) {
+
+    ValueTexture& tex = bindValueTexture(id, interpolate);
+
+    if (version < 0 || version != tex.version || tex.width == 0) {
+
+        const int width = (int)values.shape(1);
+        const int height = (int)values.shape(0);
+
+        // uint16 stays as it is (e.g. camera or depth images), everything else becomes float32
+        py::array data;
+        GLenum internalFormat;
+        GLenum datatype;
+
+        if (py::dtype::of<uint16_t>().equal(values.dtype())) {
+            array_like<uint16_t> a = array_like<uint16_t>::ensure(values);
+            valueRange(a.data(), (size_t)a.size(), tex.lo, tex.hi);
+            data = a;
+            internalFormat = GL_R16;
+            datatype = GL_UNSIGNED_SHORT;
+            tex.scale = 65535.0;
+        } else {
+            array_like<float> a = array_like<float>::ensure(values);
+            if (!a) {
+                throw py::error_already_set();
+            }
+            valueRange(a.data(), (size_t)a.size(), tex.lo, tex.hi);
+            data = a;
+            internalFormat = GL_R32F;
+            datatype = GL_FLOAT;
+            tex.scale = 1.0;
+        }
+
+        uploadTexels(tex, data.data(), width, height, internalFormat, datatype);
+        tex.version = version;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return tex;
+}
+
+/**
+ * Colormap textures, one 256 x 1 RGBA texture per colormap
+ */
+
+static const int LUT_SIZE = 256;
+
+static std::unordered_map<ImPlotColormap, GLuint> lutTextures;
+
+static GLuint lutTexture(ImPlotColormap cmap) {
+
+    auto it = lutTextures.find(cmap);
+    if (it != lutTextures.end()) {
+        return it->second;
+    }
+
+    ImU32 colors[LUT_SIZE];
+    for (int i = 0; i < LUT_SIZE; ++i) {
+        colors[i] = ImGui::ColorConvertFloat4ToU32(SampleColormap((float)i / (LUT_SIZE - 1), cmap));
+    }
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, LUT_SIZE, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, colors);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    lutTextures[cmap] = id;
+
+    return id;
+}
+
+/**
+ * Shader
+ *
+ * Drawn in between the draw commands of the imgui OpenGL backend. The
+ * program reuses the vertex layout and projection of the backend, only
+ * the fragment stage differs.
+ */
+
+static const char* HEATMAP_VERTEX_SHADER = R"(
+#version 330 core
+uniform mat4 ProjMtx;
+in vec2 Position;
+in vec2 UV;
+in vec4 Color;
+out vec2 Frag_UV;
+out vec4 Frag_Color;
+void main() {
+    Frag_UV = UV;
+    Frag_Color = Color;
+    gl_Position = ProjMtx * vec4(Position.xy, 0, 1);
+}
+)";
+
+static const char* HEATMAP_FRAGMENT_SHADER = R"(
+#version 330 core
+uniform sampler2D Values;
+uniform sampler2D Lut;
+uniform float Offset;
+uniform float Scale;
+in vec2 Frag_UV;
+in vec4 Frag_Color;
+layout (location = 0) out vec4 Out_Color;
+void main() {
+    float v = texture(Values, Frag_UV).r;
+    if (isnan(v)) {
+        discard;
+    }
+    float t = clamp((v - Offset) * Scale, 0.0, 1.0);
+    Out_Color = Frag_Color * texture(Lut, vec2((t * 255.0 + 0.5) / 256.0, 0.5));
+}
+)";
+
+struct HeatmapProgram {
+    GLuint backend = 0;
+    GLuint program = 0;
+    GLint projMtx = -1;
+    GLint values = -1;
+    GLint lut = -1;
+    GLint offset = -1;
+    GLint scale = -1;
+    bool failed = false;
+};
+
+static HeatmapProgram heatmapProgram;
+
+static GLuint compileShader(GLenum type, const char* source) {
+
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "Heatmap shader compilation failed: %s\n", log);
+    }
+
+    return shader;
+}
+
+// (re)builds the program with the attribute locations of the backend program
+static const HeatmapProgram& programFor(GLuint backend) {
+
+    HeatmapProgram& p = heatmapProgram;
+
+    if (p.backend == backend && (p.program != 0 || p.failed)) {
+        return p;
+    }
+
+    if (p.program != 0) {
+        glDeleteProgram(p.program);
+    }
+
+    p = HeatmapProgram();
+    p.backend = backend;
+
+    GLuint vs = compileShader(GL_VERTEX_SHADER, HEATMAP_VERTEX_SHADER);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, HEATMAP_FRAGMENT_SHADER);
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glBindAttribLocation(program, (GLuint)glGetAttribLocation(backend, "Position"), "Position");
+    glBindAttribLocation(program, (GLuint)glGetAttribLocation(backend, "UV"), "UV");
+    glBindAttribLocation(program, (GLuint)glGetAttribLocation(backend, "Color"), "Color");
+    glLinkProgram(program);
+
+    glDetachShader(program, vs);
+    glDetachShader(program, fs);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        fprintf(stderr, "Heatmap shader linking failed: %s\n", log);
+        glDeleteProgram(program);
+        p.failed = true;
+        return p;
+    }
+
+    p.program = program;
+    p.projMtx = glGetUniformLocation(program, "ProjMtx");
+    p.values = glGetUniformLocation(program, "Values");
+    p.lut = glGetUniformLocation(program, "Lut");
+    p.offset = glGetUniformLocation(program, "Offset");
+    p.scale = glGetUniformLocation(program, "Scale");
+
+    return p;
+}
+
+// uniforms of one heatmap, kept until the frame has been rendered
+struct HeatmapDraw {
+    GLuint lut;
+    float offset;
+    float scale;
+};
+
+static std::deque<HeatmapDraw> heatmapDraws;
+static int heatmapDrawsFrame = -1;
+
+static void drawHeatmap(const ImDrawList*, const ImDrawCmd* cmd) {
+
+    const HeatmapDraw& d = *(const HeatmapDraw*)cmd->UserCallbackData;
+
+    GLint backend = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &backend);
+
+    const HeatmapProgram& p = programFor((GLuint)backend);
+    if (p.program == 0) {
+        // the values are drawn as a plain grey image
+        return;
+    }
+
+    GLfloat proj[16];
+    glGetUniformfv((GLuint)backend, glGetUniformLocation((GLuint)backend, "ProjMtx"), proj);
+
+    glUseProgram(p.program);
+    glUniformMatrix4fv(p.projMtx, 1, GL_FALSE, proj);
+    glUniform1i(p.values, 0);
+    glUniform1i(p.lut, 1);
+    glUniform1f(p.offset, d.offset);
+    glUniform1f(p.scale, d.scale);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, d.lut);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// queues the heatmap shader around an image of tex covering [p1, p2]
+static void drawValues(
+        const ValueTexture& tex,
+        double vmin,
+        double vmax,
+        ImPlotColormap cmap,
+        const ImVec2& p1,
+        const ImVec2& p2) {
+
+    if (heatmapDrawsFrame != ImGui::GetFrameCount()) {
+        heatmapDraws.clear();
+        heatmapDrawsFrame = ImGui::GetFrameCount();
+    }
+
+    // t = (texel * scale - vmin) / (vmax - vmin)
+    HeatmapDraw draw;
+    draw.lut = lutTexture(cmap);
+    draw.offset = (float)(vmin / tex.scale);
+    draw.scale = vmax != vmin ? (float)(tex.scale / (vmax - vmin)) : 0.0f;
+
+    heatmapDraws.push_back(draw);
+
+    ImDrawList& drawList = *GetPlotDrawList();
+
+    PushPlotClipRect();
+    drawList.AddCallback(drawHeatmap, &heatmapDraws.back());
+    drawList.AddImage((ImTextureID)(intptr_t)tex.id, p1, p2);
+    drawList.AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+    PopPlotClipRect();
+}
+
+static ImPlotColormap checkColormap(ImPlotColormap cmap) {
+
+    if (cmap == IMPLOT_AUTO) {
+        cmap = GImPlot->Style.Colormap;
+    }
+    IM_ASSERT_USER_ERROR(cmap >= 0 && cmap < GImPlot->ColormapData.Count, "Invalid colormap index!");
+
+    return cmap;
+}
+
+// the item of a heatmap, its values already in tex
+static void plotValueTexture(
+        const char* label,
+        const ValueTexture& tex,
+        double vmin,
+        double vmax,
+        ImPlotColormap cmap,
+        const ImPlotPoint& boundsMin,
+        const ImPlotPoint& boundsMax,
+        ImPlotItemFlags flags) {
+
+    if (BeginItem(label, flags)) {
+
+        if (FitThisFrame()) {
+            FitPoint(boundsMin);
+            FitPoint(boundsMax);
+        }
+
+        GetCurrentItem()->Color = SampleColormapU32(0.5f, cmap);
+
+        ImVec2 p1 = PlotToPixels(boundsMin.x, boundsMax.y, IMPLOT_AUTO, IMPLOT_AUTO);
+        ImVec2 p2 = PlotToPixels(boundsMax.x, boundsMin.y, IMPLOT_AUTO, IMPLOT_AUTO);
+
+        drawValues(tex, vmin, vmax, cmap, p1, p2);
+
+        EndItem();
+    }
+}
+
+void plotHeatmap(
+        const char* label,
+        py::array& values,
+        std::optional<double> vmin,
+        std::optional<double> vmax,
+        ImPlotColormap cmap,
+        const ImPlotPoint& boundsMin,
+        const ImPlotPoint& boundsMax,
+        bool interpolate,
+        int64_t version,
+        ImPlotItemFlags flags) {
+
+    assert_shape(values, {{-1, -1}});
+
+    cmap = checkColormap(cmap);
+
+    const ValueTexture& tex = uploadValues(ImGui::GetID(label), values, version, interpolate);
+
+    const double lo = vmin.value_or(tex.lo);
+    const double hi = vmax.value_or(tex.hi);
+
+    plotValueTexture(label, tex, lo, hi, cmap, boundsMin, boundsMax, flags);
+}
+
+void plotValueImage(
+        const char* label,
+        const float* values,
+        int width,
+        int height,
+        int64_t version,
+        double vmin,
+        double vmax,
+        ImPlotColormap cmap,
+        const ImPlotPoint& boundsMin,
+        const ImPlotPoint& boundsMax,
+        ImPlotItemFlags flags) {
+
+    cmap = checkColormap(cmap);
+
+    ValueTexture& tex = bindValueTexture(ImGui::GetID(label), false);
+    if (version < 0 || version != tex.version || tex.width == 0) {
+        uploadTexels(tex, values, width, height, GL_R32F, GL_FLOAT);
+        tex.version = version;
+        tex.scale = 1.0;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    plotValueTexture(label, tex, vmin, vmax, cmap, boundsMin, boundsMax, flags);
+}
+
+void drawValueImage(
+        ImGuiID id,
+        const float* values,
+        int width,
+        int height,
+        double vmin,
+        double vmax,
+        ImPlotColormap cmap,
+        const ImVec2& p1,
+        const ImVec2& p2) {
+
+    cmap = checkColormap(cmap);
+
+    ValueTexture& tex = bindValueTexture(id, false);
+    uploadTexels(tex, values, width, height, GL_R32F, GL_FLOAT);
+    tex.version = -1;
+    tex.scale = 1.0;
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    drawValues(tex, vmin, vmax, cmap, p1, p2);
+}
+}
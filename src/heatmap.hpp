@@ -0,0 +1,67 @@
+#pragma once
+
+#include <optional>
+
+#include "binding_helpers.hpp"
+
+namespace ImPlot {
+
+/**
+ * Plots a (H, W) array as a heatmap.
+ *
+ * The values are uploaded once as a single channel float32 (or uint16)
+ * texture and mapped through a colormap texture by a small shader when
+ * the plot is drawn. Changing vmin, vmax or the colormap therefore does
+ * not require a new upload. Data is only uploaded again if the version
+ * changes, or on every call if version is negative.
+ *
+ * Unset vmin and vmax are replaced by the range of the data.
+ */
+void plotHeatmap(
+        const char* label,
+        py::array& values,
+        std::optional<double> vmin,
+        std::optional<double> vmax,
+        ImPlotColormap cmap,
+        const ImPlotPoint& boundsMin,
+        const ImPlotPoint& boundsMax,
+        bool interpolate,
+        int64_t version,
+        ImPlotItemFlags flags = ImPlotItemFlags_None);
+
+/**
+ * Plots a (height, width) float32 buffer as a heatmap, for items which
+ * keep their values in C++ (e.g. cached histogram counts). The buffer is
+ * only uploaded again if version changes, or on every call if version is
+ * negative.
+ */
+void plotValueImage(
+        const char* label,
+        const float* values,
+        int width,
+        int height,
+        int64_t version,
+        double vmin,
+        double vmax,
+        ImPlotColormap cmap,
+        const ImPlotPoint& boundsMin,
+        const ImPlotPoint& boundsMax,
+        ImPlotItemFlags flags = ImPlotItemFlags_None);
+
+/**
+ * Draws a (height, width) float32 buffer mapped through a colormap into
+ * the pixel rect [p1, p2] of the current plot, for items which compute
+ * their values anew every frame. NaN values stay transparent. Has to be
+ * called between BeginItem() and EndItem().
+ */
+void drawValueImage(
+        ImGuiID id,
+        const float* values,
+        int width,
+        int height,
+        double vmin,
+        double vmax,
+        ImPlotColormap cmap,
+        const ImVec2& p1,
+        const ImVec2& p2);
+}
@@ -26,21 +26,91 @@ SOFTWARE.
 */
 
 #include "implot_ext.hpp"
+#include "parallel.hpp"
+#include "simd_kernels.hpp"
+#include "heatmap.hpp"
+#include "marker_sprites.hpp"
 
 // this is stupid ... i like it so much
 #include "implot_items.cpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <sstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 
 namespace ImPlot {
 
-IMPLOT_INLINE void PrimLineCol2(ImDrawList& draw_list, const ImVec2& P1, const ImVec2& P2, float half_weight, ImU32 col0, ImU32 col1, const ImVec2& tex_uv0, const ImVec2 tex_uv1) {
-    float dx = P2.x - P1.x;
-    float dy = P2.y - P1.y;
-    IMPLOT_NORMALIZE2F_OVER_ZERO(dx, dy);
-    dx *= half_weight;
-    dy *= half_weight;
+/**
+ * Batched line strips
+ *
+ * Instead of transforming and culling one segment at a time, the line strip
+ * renderers process blocks of LINE_BATCH segments with the SIMD kernels in
+ * simd_kernels.hpp. Only writing the vertices of visible segments is left
+ * to Render().
+ */
+
+static const int LINE_BATCH = 256;
+
+// x or y of the block in plot space to pixels, non-linear scales are
+// mapped to their linear plot range first (see Transformer1)
+void TransformBatch(const Transformer1& t, double* values, float* pixels, int count) {
+    if (t.TransformFwd != nullptr) {
+        for (int i = 0; i < count; ++i) {
+            double s = t.TransformFwd(values[i], t.TransformData);
+            values[i] = t.PltMin + (t.PltMax - t.PltMin) * (s - t.ScaMin) / (t.ScaMax - t.ScaMin);
+        }
+    }
+    kernels::transform(values, pixels, count, t.PltMin, t.M, t.PixMin);
+}
+
+template <class _Getter>
+struct LineStripBatch {
+    // loads the block containing segment prim and returns its index in the block
+    IMPLOT_INLINE int Index(const _Getter& getter, const Transformer2& transformer, const ImRect& cull_rect, float half_weight, int prim) const {
+        if (prim < First || prim >= First + Segments) {
+            Load(getter, transformer, cull_rect, half_weight, prim);
+        }
+        return prim - First;
+    }
+    void Load(const _Getter& getter, const Transformer2& transformer, const ImRect& cull_rect, float half_weight, int prim) const {
+        const int count = ImMin(LINE_BATCH + 1, getter.Count - prim);
+        for (int i = 0; i < count; ++i) {
+            ImPlotPoint p = getter(prim + i);
+            X[i] = p.x;
+            Y[i] = p.y;
+        }
+        TransformBatch(transformer.Tx, X, Px, count);
+        TransformBatch(transformer.Ty, Y, Py, count);
+        const float rect[4] = {cull_rect.Min.x, cull_rect.Min.y, cull_rect.Max.x, cull_rect.Max.y};
+        kernels::cullSegments(Px, Py, count, rect, Visible);
+        kernels::segmentNormals(Px, Py, count, half_weight, Nx, Ny);
+        First = prim;
+        Segments = count - 1;
+    }
+    mutable int First = 0;
+    mutable int Segments = 0;
+    mutable double X[LINE_BATCH + 1];
+    mutable double Y[LINE_BATCH + 1];
+    mutable float Px[LINE_BATCH + 1];
+    mutable float Py[LINE_BATCH + 1];
+    mutable float Nx[LINE_BATCH];
+    mutable float Ny[LINE_BATCH];
+    mutable uint8_t Visible[LINE_BATCH];
+};
+
+// same as PrimLine, but with the normalized and scaled direction (dx, dy) of the segment
+IMPLOT_INLINE void PrimLineCol2(ImDrawList& draw_list, const ImVec2& P1, const ImVec2& P2, float dx, float dy, ImU32 col0, ImU32 col1, const ImVec2& tex_uv0, const ImVec2 tex_uv1) {
     draw_list._VtxWritePtr[0].pos.x = P1.x + dy;
     draw_list._VtxWritePtr[0].pos.y = P1.y - dx;
     draw_list._VtxWritePtr[0].uv    = tex_uv0;
@@ -68,6 +138,35 @@ IMPLOT_INLINE void PrimLineCol2(ImDrawList& draw_list, const ImVec2& P1, const I
     draw_list._VtxCurrentIdx += 4;
 }
 
+template <class _Getter>
+struct RendererLineStripBatched : RendererBase {
+    RendererLineStripBatched(const _Getter& getter, ImU32 col, float weight) :
+        RendererBase(getter.Count - 1, 6, 4),
+        Getter(getter),
+        Col(col),
+        HalfWeight(ImMax(1.0f,weight)*0.5f)
+    { }
+    void Init(ImDrawList& draw_list) const {
+        GetLineRenderProps(draw_list, HalfWeight, UV0, UV1);
+    }
+    IMPLOT_INLINE bool Render(ImDrawList& draw_list, const ImRect& cull_rect, int prim) const {
+        const int i = Batch.Index(Getter, this->Transformer, cull_rect, HalfWeight, prim);
+        if (!Batch.Visible[i]) {
+            return false;
+        }
+        ImVec2 P1(Batch.Px[i], Batch.Py[i]);
+        ImVec2 P2(Batch.Px[i+1], Batch.Py[i+1]);
+        PrimLineCol2(draw_list,P1,P2,Batch.Nx[i],Batch.Ny[i],Col,Col,UV0,UV1);
+        return true;
+    }
+    const _Getter& Getter;
+    const ImU32 Col;
+    mutable float HalfWeight;
+    mutable ImVec2 UV0;
+    mutable ImVec2 UV1;
+    LineStripBatch<_Getter> Batch;
+};
+
 template <class _Getter>
 struct CustomRendererLineStrip : RendererBase {
     CustomRendererLineStrip(const _Getter& getter, ImU32 col, float weight) :
@@ -75,32 +174,30 @@ struct CustomRendererLineStrip : RendererBase {
         Getter(getter),
         Col(col),
         HalfWeight(ImMax(1.0f,weight)*0.5f)
-    {
-        P1 = this->Transformer(Getter(0));
-    }
+    { }
     void Init(ImDrawList& draw_list) const {
         GetLineRenderProps(draw_list, HalfWeight, UV0, UV1);
     }
     IMPLOT_INLINE bool Render(ImDrawList& draw_list, const ImRect& cull_rect, int prim) const {
-        ImVec2 P2 = this->Transformer(Getter(prim + 1));
-        if (!cull_rect.Overlaps(ImRect(ImMin(P1, P2), ImMax(P1, P2)))) {
-            P1 = P2;
+        const int i = Batch.Index(Getter, this->Transformer, cull_rect, HalfWeight, prim);
+        if (!Batch.Visible[i]) {
             return false;
         }
-        ImU32 col0 = ImGui::ColorConvertFloat4ToU32(colors[prim]);
-        ImU32 col1 = ImGui::ColorConvertFloat4ToU32(colors[prim+1]);
-        PrimLineCol2(draw_list,P1,P2,HalfWeight,col0,col1,UV0,UV1);
-        P1 = P2;
+        ImVec2 P1(Batch.Px[i], Batch.Py[i]);
+        ImVec2 P2(Batch.Px[i+1], Batch.Py[i+1]);
+        ImU32 col0 = colors[prim];
+        ImU32 col1 = colors[prim+1];
+        PrimLineCol2(draw_list,P1,P2,Batch.Nx[i],Batch.Ny[i],col0,col1,UV0,UV1);
         return true;
     }
     const _Getter& Getter;
     const ImU32 Col;
     mutable float HalfWeight;
-    mutable ImVec2 P1;
     mutable ImVec2 UV0;
     mutable ImVec2 UV1;
+    LineStripBatch<_Getter> Batch;
 
-    inline static ImVec4* colors;
+    inline static const ImU32* colors;
 };
 
 template <class _Getter>
@@ -118,7 +215,7 @@ struct CustomRendererMarkersFill : RendererBase {
     }
     IMPLOT_INLINE bool Render(ImDrawList& draw_list, const ImRect& cull_rect, int prim) const {
         ImVec2 p = this->Transformer(Getter(prim));
-        ImU32 col0 = ImGui::ColorConvertFloat4ToU32(colors[prim]);
+        ImU32 col0 = colors[prim];
         if (p.x >= cull_rect.Min.x && p.y >= cull_rect.Min.y && p.x <= cull_rect.Max.x && p.y <= cull_rect.Max.y) {
             for (int i = 0; i < Count; i++) {
                 draw_list._VtxWritePtr[0].pos.x = p.x + Marker[i].x * Size;
@@ -146,7 +243,7 @@ struct CustomRendererMarkersFill : RendererBase {
     const ImU32 Col;
     mutable ImVec2 UV;
 
-    inline static ImVec4* colors;
+    inline static const ImU32* colors;
 };
 
 template <class _Getter>
@@ -165,7 +262,7 @@ struct CustomRendererMarkersLine : RendererBase {
     }
     IMPLOT_INLINE bool Render(ImDrawList& draw_list, const ImRect& cull_rect, int prim) const {
         ImVec2 p = this->Transformer(Getter(prim));
-        ImU32 col0 = ImGui::ColorConvertFloat4ToU32(colors[prim]);
+        ImU32 col0 = colors[prim];
         if (p.x >= cull_rect.Min.x && p.y >= cull_rect.Min.y && p.x <= cull_rect.Max.x && p.y <= cull_rect.Max.y) {
             for (int i = 0; i < Count; i = i + 2) {
                 ImVec2 p1(p.x + Marker[i].x * Size, p.y + Marker[i].y * Size);
@@ -185,95 +282,2898 @@ struct CustomRendererMarkersLine : RendererBase {
     mutable ImVec2 UV0;
     mutable ImVec2 UV1;
 
-    inline static ImVec4* colors;
+    inline static const ImU32* colors;
+};
+
+/**
+ * Draws every marker as one quad textured with its sprite from the font
+ * atlas, in one color or with per marker colors.
+ */
+template <class _Getter>
+struct RendererMarkerSprites : RendererBase {
+    RendererMarkerSprites(const _Getter& getter, const MarkerSprite* sprite, float size, ImU32 col, const ImU32* colors) :
+        RendererBase(getter.Count, 6, 4),
+        Getter(getter),
+        UV0(sprite->uv0),
+        UV1(sprite->uv1),
+        Extent(size * sprite->extent),
+        Col(col),
+        Colors(colors)
+    { }
+    void Init(ImDrawList&) const { }
+    IMPLOT_INLINE bool Render(ImDrawList& draw_list, const ImRect& cull_rect, int prim) const {
+        ImVec2 p = this->Transformer(Getter(prim));
+        if (p.x >= cull_rect.Min.x && p.y >= cull_rect.Min.y && p.x <= cull_rect.Max.x && p.y <= cull_rect.Max.y) {
+            const ImU32 col = Colors != nullptr ? Colors[prim] : Col;
+            ImDrawVert* v = draw_list._VtxWritePtr;
+            v[0].pos.x = p.x - Extent; v[0].pos.y = p.y - Extent; v[0].uv = UV0;                 v[0].col = col;
+            v[1].pos.x = p.x + Extent; v[1].pos.y = p.y - Extent; v[1].uv = ImVec2(UV1.x, UV0.y); v[1].col = col;
+            v[2].pos.x = p.x + Extent; v[2].pos.y = p.y + Extent; v[2].uv = UV1;                 v[2].col = col;
+            v[3].pos.x = p.x - Extent; v[3].pos.y = p.y + Extent; v[3].uv = ImVec2(UV0.x, UV1.y); v[3].col = col;
+            draw_list._VtxWritePtr += 4;
+            ImDrawIdx* i = draw_list._IdxWritePtr;
+            const ImDrawIdx base = (ImDrawIdx)draw_list._VtxCurrentIdx;
+            i[0] = base; i[1] = (ImDrawIdx)(base + 1); i[2] = (ImDrawIdx)(base + 2);
+            i[3] = base; i[4] = (ImDrawIdx)(base + 2); i[5] = (ImDrawIdx)(base + 3);
+            draw_list._IdxWritePtr += 6;
+            draw_list._VtxCurrentIdx += 4;
+            return true;
+        }
+        return false;
+    }
+    const _Getter& Getter;
+    const ImVec2 UV0;
+    const ImVec2 UV1;
+    const float Extent;
+    const ImU32 Col;
+    const ImU32* Colors;
 };
 
+/**
+ * Parallel geometry
+ *
+ * Large series are split into chunks of primitives, which are rendered into
+ * scratch draw lists by the worker threads (with the GIL released). The
+ * results are appended to the plot's draw list in order afterwards, so the
+ * output is the same as that of RenderPrimitives1.
+ */
+
+static const unsigned int PARALLEL_MIN_CHUNK_PRIMS = 32768;
+
+static std::vector<std::unique_ptr<ImDrawList>> scratchLists;
+
+// renderers with a line strip state continue from the first sample of their chunk,
+// batched renderers load the block of their first primitive on demand
+template <class _Renderer>
+auto BeginChunk(const _Renderer& renderer, unsigned int prim, int) -> decltype(renderer.P1, void()) {
+    renderer.P1 = renderer.Transformer(renderer.Getter(prim));
+}
+
+template <class _Renderer>
+void BeginChunk(const _Renderer&, unsigned int, long) { }
+
+// same as RenderPrimitivesEx, but only for the primitives [begin, end)
+template <class _Renderer>
+void RenderPrimitivesRange(const _Renderer& renderer, ImDrawList& draw_list, const ImRect& cull_rect, unsigned int begin, unsigned int end) {
+    unsigned int prims        = end - begin;
+    unsigned int prims_culled = 0;
+    unsigned int idx          = begin;
+    renderer.Init(draw_list);
+    while (prims) {
+        unsigned int cnt = ImMin(prims, (MaxIdx<ImDrawIdx>::Value - draw_list._VtxCurrentIdx) / renderer.VtxConsumed);
+        if (cnt >= ImMin(64u, prims)) {
+            if (prims_culled >= cnt)
+                prims_culled -= cnt;
+            else {
+                draw_list.PrimReserve((cnt - prims_culled) * renderer.IdxConsumed, (cnt - prims_culled) * renderer.VtxConsumed);
+                prims_culled = 0;
+            }
+        }
+        else {
+            if (prims_culled > 0) {
+                draw_list.PrimUnreserve(prims_culled * renderer.IdxConsumed, prims_culled * renderer.VtxConsumed);
+                prims_culled = 0;
+            }
+            cnt = ImMin(prims, (MaxIdx<ImDrawIdx>::Value - 0) / renderer.VtxConsumed);
+            draw_list.PrimReserve(cnt * renderer.IdxConsumed, cnt * renderer.VtxConsumed);
+        }
+        prims -= cnt;
+        for (unsigned int ie = idx + cnt; idx != ie; ++idx) {
+            if (!renderer.Render(draw_list, cull_rect, idx))
+                prims_culled++;
+        }
+    }
+    if (prims_culled > 0)
+        draw_list.PrimUnreserve(prims_culled * renderer.IdxConsumed, prims_culled * renderer.VtxConsumed);
+}
+
+// appends the geometry of src, indices are rebased onto the vertices of dst
+void AppendDrawList(ImDrawList& dst, const ImDrawList& src) {
+    for (int c = 0; c < src.CmdBuffer.Size; ++c) {
+        const ImDrawCmd& cmd = src.CmdBuffer[c];
+        if (cmd.ElemCount == 0) {
+            continue;
+        }
+        int vtxEnd = src.VtxBuffer.Size;
+        for (int n = c + 1; n < src.CmdBuffer.Size; ++n) {
+            if (src.CmdBuffer[n].VtxOffset != cmd.VtxOffset) {
+                vtxEnd = (int)src.CmdBuffer[n].VtxOffset;
+                break;
+            }
+        }
+        const int vtxCount = vtxEnd - (int)cmd.VtxOffset;
+        dst.PrimReserve((int)cmd.ElemCount, vtxCount);
+        memcpy(dst._VtxWritePtr, src.VtxBuffer.Data + cmd.VtxOffset, vtxCount * sizeof(ImDrawVert));
+        const ImDrawIdx* idx = src.IdxBuffer.Data + cmd.IdxOffset;
+        for (unsigned int i = 0; i < cmd.ElemCount; ++i) {
+            dst._IdxWritePtr[i] = (ImDrawIdx)(dst._VtxCurrentIdx + idx[i]);
+        }
+        dst._VtxWritePtr += vtxCount;
+        dst._IdxWritePtr += cmd.ElemCount;
+        dst._VtxCurrentIdx += vtxCount;
+    }
+}
+
+template <template <class> class _Renderer, class _Getter, typename ...Args>
+void RenderPrimitivesParallel(const _Getter& getter, Args... args) {
+    ImDrawList& draw_list = *GetPlotDrawList();
+    const ImRect& cull_rect = GetCurrentPlot()->PlotRect;
+
+    const _Renderer<_Getter> renderer(getter, args...);
+    const unsigned int chunks = ImMin((unsigned int)parallel::threadCount(), renderer.Prims / PARALLEL_MIN_CHUNK_PRIMS);
+
+    if (chunks < 2) {
+        RenderPrimitivesEx(renderer, draw_list, cull_rect);
+        return;
+    }
+
+    // renderers are stateful, every chunk gets its own copy
+    std::vector<_Renderer<_Getter>> renderers(chunks, renderer);
+
+    ImDrawListSharedData* shared = ImGui::GetDrawListSharedData();
+    while (scratchLists.size() < chunks) {
+        scratchLists.emplace_back(new ImDrawList(shared));
+    }
+
+    // reserve everything up front, workers must not allocate through ImGui
+    for (unsigned int c = 0; c < chunks; ++c) {
+        if (scratchLists[c]->_Data != shared) {
+            scratchLists[c].reset(new ImDrawList(shared));
+        }
+        ImDrawList& scratch = *scratchLists[c];
+        const unsigned int prims = renderer.Prims / chunks + 1;
+        scratch._ResetForNewFrame();
+        scratch.Flags = draw_list.Flags;
+        scratch.VtxBuffer.reserve(prims * renderer.VtxConsumed);
+        scratch.IdxBuffer.reserve(prims * renderer.IdxConsumed);
+        scratch.CmdBuffer.reserve(prims * renderer.VtxConsumed / MaxIdx<ImDrawIdx>::Value + 2);
+        scratch.AddDrawCmd();
+    }
+
+    {
+        py::gil_scoped_release release;
+        parallel::run((int)chunks, [&](int c) {
+            const unsigned int begin = (unsigned int)((uint64_t)renderer.Prims * c / chunks);
+            const unsigned int end = (unsigned int)((uint64_t)renderer.Prims * (c + 1) / chunks);
+            BeginChunk(renderers[c], begin, 0);
+            RenderPrimitivesRange(renderers[c], *scratchLists[c], cull_rect, begin, end);
+        });
+    }
+
+    for (unsigned int c = 0; c < chunks; ++c) {
+        AppendDrawList(draw_list, *scratchLists[c]);
+    }
+}
+
+/**
+ * Marker sprites
+ *
+ * Below SPRITE_MIN_MARKERS markers the tessellated geometry costs next to
+ * nothing, above it every marker with a matching sprite is drawn as a quad.
+ */
+
+static const int SPRITE_MIN_MARKERS = 4096;
+
+static bool markerSprites = true;
+
+void setMarkerSprites(bool enabled) {
+
+    markerSprites = enabled;
+}
+
+// returns false if the fill (or outline) of the markers has no sprite
+template <typename _Getter>
+bool RenderMarkerSprites(const _Getter& getter, ImPlotMarker marker, float size, bool fill, ImU32 col, float weight, const ImU32* colors) {
+    if (!markerSprites || getter.Count < SPRITE_MIN_MARKERS) {
+        return false;
+    }
+    const MarkerSprite* sprite = findMarkerSprite(marker, fill, size, weight);
+    if (sprite == nullptr) {
+        return false;
+    }
+    RenderPrimitivesParallel<RendererMarkerSprites>(getter, sprite, size, col, colors);
+    return true;
+}
+
+// same as RenderMarkers, but with sprites where possible, fills are drawn before outlines
+template <typename _Getter>
+void RenderMarkersSprited(const _Getter& getter, ImPlotMarker marker, float size, bool rend_fill, ImU32 col_fill, bool rend_line, ImU32 col_line, float weight) {
+    if (rend_fill && !RenderMarkerSprites(getter, marker, size, true, col_fill, weight, nullptr)) {
+        RenderMarkers<_Getter>(getter, marker, size, true, col_fill, false, col_line, weight);
+    }
+    if (rend_line && !RenderMarkerSprites(getter, marker, size, false, col_line, weight, nullptr)) {
+        RenderMarkers<_Getter>(getter, marker, size, false, col_fill, true, col_line, weight);
+    }
+}
+
 template <typename _Getter>
 void CustomRenderMarkers(const _Getter& getter, ImPlotMarker marker, float size, bool rend_fill, ImU32 col_fill, bool rend_line, ImU32 col_line, float weight) {
+    const ImU32* colors = CustomRendererMarkersFill<_Getter>::colors;
+    if (rend_fill && RenderMarkerSprites(getter, marker, size, true, col_fill, weight, colors)) {
+        rend_fill = false;
+    }
     if (rend_fill) {
         switch (marker) {
-            case ImPlotMarker_Circle  : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_CIRCLE,10,size,col_fill); break;
-            case ImPlotMarker_Square  : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_SQUARE, 4,size,col_fill); break;
-            case ImPlotMarker_Diamond : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_DIAMOND,4,size,col_fill); break;
-            case ImPlotMarker_Up      : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_UP,     3,size,col_fill); break;
-            case ImPlotMarker_Down    : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_DOWN,   3,size,col_fill); break;
-            case ImPlotMarker_Left    : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_LEFT,   3,size,col_fill); break;
-            case ImPlotMarker_Right   : RenderPrimitives1<CustomRendererMarkersFill>(getter,MARKER_FILL_RIGHT,  3,size,col_fill); break;
+            case ImPlotMarker_Circle  : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_CIRCLE,10,size,col_fill); break;
+            case ImPlotMarker_Square  : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_SQUARE, 4,size,col_fill); break;
+            case ImPlotMarker_Diamond : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_DIAMOND,4,size,col_fill); break;
+            case ImPlotMarker_Up      : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_UP,     3,size,col_fill); break;
+            case ImPlotMarker_Down    : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_DOWN,   3,size,col_fill); break;
+            case ImPlotMarker_Left    : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_LEFT,   3,size,col_fill); break;
+            case ImPlotMarker_Right   : RenderPrimitivesParallel<CustomRendererMarkersFill>(getter,MARKER_FILL_RIGHT,  3,size,col_fill); break;
         }
     }
+    if (rend_line && RenderMarkerSprites(getter, marker, size, false, col_line, weight, colors)) {
+        rend_line = false;
+    }
     if (rend_line) {
         switch (marker) {
-            case ImPlotMarker_Circle    : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_CIRCLE, 20,size,weight,col_line); break;
-            case ImPlotMarker_Square    : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_SQUARE,  8,size,weight,col_line); break;
-            case ImPlotMarker_Diamond   : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_DIAMOND, 8,size,weight,col_line); break;
-            case ImPlotMarker_Up        : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_UP,      6,size,weight,col_line); break;
-            case ImPlotMarker_Down      : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_DOWN,    6,size,weight,col_line); break;
-            case ImPlotMarker_Left      : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_LEFT,    6,size,weight,col_line); break;
-            case ImPlotMarker_Right     : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_RIGHT,   6,size,weight,col_line); break;
-            case ImPlotMarker_Asterisk  : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_ASTERISK,6,size,weight,col_line); break;
-            case ImPlotMarker_Plus      : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_PLUS,    4,size,weight,col_line); break;
-            case ImPlotMarker_Cross     : RenderPrimitives1<CustomRendererMarkersLine>(getter,MARKER_LINE_CROSS,   4,size,weight,col_line); break;
+            case ImPlotMarker_Circle    : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_CIRCLE, 20,size,weight,col_line); break;
+            case ImPlotMarker_Square    : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_SQUARE,  8,size,weight,col_line); break;
+            case ImPlotMarker_Diamond   : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_DIAMOND, 8,size,weight,col_line); break;
+            case ImPlotMarker_Up        : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_UP,      6,size,weight,col_line); break;
+            case ImPlotMarker_Down      : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_DOWN,    6,size,weight,col_line); break;
+            case ImPlotMarker_Left      : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_LEFT,    6,size,weight,col_line); break;
+            case ImPlotMarker_Right     : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_RIGHT,   6,size,weight,col_line); break;
+            case ImPlotMarker_Asterisk  : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_ASTERISK,6,size,weight,col_line); break;
+            case ImPlotMarker_Plus      : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_PLUS,    4,size,weight,col_line); break;
+            case ImPlotMarker_Cross     : RenderPrimitivesParallel<CustomRendererMarkersLine>(getter,MARKER_LINE_CROSS,   4,size,weight,col_line); break;
         }
     }
 }
 
-void customPlot(
-        const char* label,
-        PlotArrayInfo& pai,
-        py::handle color,
-        bool noLine,
-        ImPlotFlags flags) {
+/**
+ * Line decimation
+ *
+ * Reduces every pixel column of the plot to the first, minimum, maximum and
+ * last sample falling into it (M4). A line strip through the remaining samples
+ * looks the same as one through all samples, but the amount of generated
+ * geometry only depends on the width of the plot.
+ */
 
-    GetterXY<IndexerIdx<double>, IndexerIdx<double>> getter(
-             IndexerIdx<double>(pai.xDataPtr, pai.count, 0, sizeof(double)),
-             IndexerIdx<double>(pai.yDataPtr, pai.count, 0, sizeof(double)),
-             pai.count);
+// decimation only pays off if there are considerably more samples than pixels
+static const int M4_MIN_SAMPLES_PER_COLUMN = 4;
 
-    if (BeginItemEx(
-                label,
-                Fitter1(getter),
-                flags,
-                ImPlotCol_Line)) {
+static std::vector<int> m4Indices;
+static std::vector<ImU32> m4Colors;
+
+template <typename _Getter>
+struct GetterIndexed {
+    GetterIndexed(const _Getter& getter, const int* indices, int count) :
+        Getter(getter),
+        Indices(indices),
+        Count(count)
+    { }
+    template <typename I> IMPLOT_INLINE ImPlotPoint operator()(I idx) const {
+        return Getter(Indices[idx]);
+    }
+    const _Getter& Getter;
+    const int* Indices;
+    const int Count;
+};
+
+bool shouldDecimate(int count, ImPlotLineFlags flags) {
+
+    if (ImHasFlag(flags, ImPlotLineFlags_Segments)
+            || ImHasFlag(flags, ImPlotLineFlags_Loop)) {
+        return false;
+    }
+
+    ImPlotPlot& plot = *GetCurrentPlot();
+
+    return count > M4_MIN_SAMPLES_PER_COLUMN * plot.PlotRect.GetWidth();
+}
+
+/**
+ * Finds the range [first, last] of samples, which may be visible in the
+ * current plot, by binary searching x. Requires x in ascending order.
+ * One sample on each side of the plot is included, so that lines leaving
+ * the plot are still drawn.
+ */
+template <typename _Getter>
+void visibleRange(const _Getter& getter, int& first, int& last) {
 
-        array_like<float> colArr = array_like<float>::ensure(color);
+    ImPlotPlot& plot = *GetCurrentPlot();
+    const ImPlotRange& range = plot.Axes[plot.CurrentX].Range;
 
-        if ((size_t)colArr.shape(0) != pai.count) {
-            std::stringstream ss;
-            ss << "color array size ("
-               << colArr.shape(0)
-               << ") != number of points ("
-               << pai.count
-               << ")";
-            throw py::value_error(ss.str());
+    // first sample with x >= range.Min
+    int lo = 0;
+    int hi = getter.Count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (getter(mid).x < range.Min) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
+    }
+    first = ImMax(lo - 1, 0);
 
-        CustomRendererLineStrip<decltype(getter)>::colors = (ImVec4*)colArr.mutable_data(0);
-        CustomRendererMarkersFill<decltype(getter)>::colors = (ImVec4*)colArr.mutable_data(0);
-        CustomRendererMarkersLine<decltype(getter)>::colors = (ImVec4*)colArr.mutable_data(0);
+    // first sample with x > range.Max
+    hi = getter.Count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (getter(mid).x <= range.Max) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    last = ImMin(lo, getter.Count - 1);
+}
 
-        const ImPlotNextItemData& s = ImPlot::GetItemData();
+template <typename _Getter>
+struct GetterRange {
+    GetterRange(const _Getter& getter, int first, int count) :
+        Getter(getter),
+        First(first),
+        Count(count)
+    { }
+    template <typename I> IMPLOT_INLINE ImPlotPoint operator()(I idx) const {
+        return Getter(First + idx);
+    }
+    const _Getter& Getter;
+    const int First;
+    const int Count;
+};
 
-        if (pai.count > 1 && s.RenderLine && noLine == false) {
-            const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
-            RenderPrimitives1<CustomRendererLineStrip>(getter, col_line, s.LineWeight);
+/**
+ * Restricts a getter to the samples, which may be visible in the current plot.
+ * Without sorted x every sample may be visible and the getter is passed through.
+ */
+template <typename _Getter>
+GetterRange<_Getter> visibleSamples(const _Getter& getter, bool xSorted) {
+
+    int first = 0;
+    int last = getter.Count - 1;
+    if (xSorted) {
+        visibleRange(getter, first, last);
+    }
+
+    return GetterRange<_Getter>(getter, first, last - first + 1);
+}
+
+/**
+ * Pixel deduplication
+ *
+ * Keeps only the markers, which change the pixel they land on. A marker
+ * is skipped if the last kept marker in its pixel has the same color.
+ * Pixels are marked as occupied with a stamp that changes for every
+ * series, so the occupancy buffers are reused without being cleared.
+ */
+
+static std::vector<uint32_t> occupancyStamps;
+static std::vector<ImU32> occupancyColors;
+static uint32_t occupancyStamp = 0;
+
+static std::vector<int> dedupIndices;
+static std::vector<ImU32> dedupColors;
+
+template <typename _Getter>
+void dedupPixels(const _Getter& getter, const ImU32* colors, std::vector<int>& indices) {
+
+    const ImRect rect = GetCurrentPlot()->PlotRect;
+    const int width = (int)rect.GetWidth() + 1;
+    const int height = (int)rect.GetHeight() + 1;
+    const size_t pixels = (size_t)ImMax(width, 0) * ImMax(height, 0);
+
+    if (occupancyStamps.size() < pixels) {
+        occupancyStamps.assign(pixels, 0);
+        occupancyColors.resize(pixels);
+    }
+    occupancyStamp += 1;
+    if (occupancyStamp == 0) {
+        std::fill(occupancyStamps.begin(), occupancyStamps.end(), 0);
+        occupancyStamp = 1;
+    }
+
+    indices.clear();
+
+    Transformer2 transformer;
+
+    for (int i = 0; i < getter.Count; ++i) {
+        ImPlotPoint p = getter(i);
+        if (ImNanOrInf(p.x) || ImNanOrInf(p.y)) {
+            continue;
+        }
+        // markers off the plot are culled by the renderers anyway
+        ImVec2 px = transformer(p);
+        float col = px.x - rect.Min.x;
+        float row = px.y - rect.Min.y;
+        if (!(col >= 0.0f && col < width && row >= 0.0f && row < height)) {
+            continue;
+        }
+        const size_t k = (size_t)row * width + (size_t)col;
+        const ImU32 c = colors != nullptr ? colors[i] : 0;
+        if (occupancyStamps[k] == occupancyStamp && occupancyColors[k] == c) {
+            continue;
+        }
+        occupancyStamps[k] = occupancyStamp;
+        occupancyColors[k] = c;
+        indices.push_back(i);
+    }
+}
+
+template <typename _Getter>
+void decimateM4(const _Getter& getter, std::vector<int>& indices, bool xSorted) {
+
+    ImPlotPlot& plot = *GetCurrentPlot();
+    ImPlotAxis& xAxis = plot.Axes[plot.CurrentX];
+
+    // everything left or right of the plot collapses into a single column
+    const int colMin = (int)std::floor(plot.PlotRect.Min.x) - 1;
+    const int colMax = (int)std::ceil(plot.PlotRect.Max.x) + 1;
+    const int noCol = colMin - 1;
+
+    int col = noCol;
+    int first = 0;
+    int last = 0;
+    int iMin = 0;
+    int iMax = 0;
+    double yMin = 0.0;
+    double yMax = 0.0;
+
+    auto flush = [&]() {
+        int prev = first;
+        indices.push_back(first);
+        for (int i : {ImMin(iMin, iMax), ImMax(iMin, iMax), last}) {
+            if (i > prev) {
+                indices.push_back(i);
+                prev = i;
+            }
+        }
+    };
+
+    indices.clear();
+
+    // sorted samples outside of the plot cannot be visible
+    int begin = 0;
+    int end = getter.Count - 1;
+    if (xSorted) {
+        visibleRange(getter, begin, end);
+    }
+
+    for (int i = begin; i <= end; ++i) {
+        ImPlotPoint p = getter(i);
+
+        if (ImNanOrInf(p.x) || ImNanOrInf(p.y)) {
+            // keep invalid samples, so that gaps stay gaps
+            if (col != noCol) {
+                flush();
+            }
+            indices.push_back(i);
+            col = noCol;
+            continue;
+        }
+
+        float px = xAxis.PlotToPixels(p.x);
+        int c = colMin;
+        if (px >= colMax) {
+            c = colMax;
+        } else if (px > colMin) {
+            c = (int)std::floor(px);
+        }
+
+        if (c != col) {
+            if (col != noCol) {
+                flush();
+            }
+            col = c;
+            first = last = iMin = iMax = i;
+            yMin = yMax = p.y;
+        } else {
+            last = i;
+            if (p.y < yMin) {
+                yMin = p.y;
+                iMin = i;
+            }
+            if (p.y > yMax) {
+                yMax = p.y;
+                iMax = i;
+            }
+        }
+    }
+
+    if (col != noCol) {
+        flush();
+    }
+}
+
+template <typename _Getter>
+void RenderLine(const _Getter& getter, ImPlotLineFlags flags, const ImPlotNextItemData& s) {
+    if (ImHasFlag(flags, ImPlotLineFlags_Shaded) && s.RenderFill) {
+        const ImU32 col_fill = ImGui::GetColorU32(s.Colors[ImPlotCol_Fill]);
+        GetterOverrideY<_Getter> getter2(getter, 0);
+        RenderPrimitives2<RendererShaded>(getter,getter2,col_fill);
+    }
+    if (s.RenderLine) {
+        const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
+        if (ImHasFlag(flags,ImPlotLineFlags_Segments)) {
+            RenderPrimitivesParallel<RendererLineSegments1>(getter,col_line,s.LineWeight);
+        }
+        else if (ImHasFlag(flags, ImPlotLineFlags_Loop)) {
+            if (ImHasFlag(flags, ImPlotLineFlags_SkipNaN))
+                RenderPrimitivesParallel<RendererLineStripSkip>(GetterLoop<_Getter>(getter),col_line,s.LineWeight);
+            else
+                RenderPrimitivesParallel<RendererLineStripBatched>(GetterLoop<_Getter>(getter),col_line,s.LineWeight);
+        }
+        else {
+            if (ImHasFlag(flags, ImPlotLineFlags_SkipNaN))
+                RenderPrimitivesParallel<RendererLineStripSkip>(getter,col_line,s.LineWeight);
+            else
+                RenderPrimitivesParallel<RendererLineStripBatched>(getter,col_line,s.LineWeight);
+        }
+    }
+}
+
+/**
+ * Same as PlotLineEx, but the line (and its shading) is decimated if requested.
+ * Markers are still rendered for every single sample.
+ */
+template <typename _Getter, typename _Fitter>
+void PlotLineDecimatedEx(const char* label_id, const _Getter& getter, const _Fitter& fitter, ImPlotLineFlags flags, bool decimate, bool xSorted) {
+    if (BeginItemEx(label_id, fitter, flags, ImPlotCol_Line)) {
+        if (getter.Count <= 0) {
+            EndItem();
+            return;
+        }
+        const ImPlotNextItemData& s = GetItemData();
+        // segments and loops cannot be cut to the visible samples
+        const bool cull = xSorted
+            && !ImHasFlag(flags, ImPlotLineFlags_Segments)
+            && !ImHasFlag(flags, ImPlotLineFlags_Loop);
+        if (getter.Count > 1) {
+            if (decimate && shouldDecimate(getter.Count, flags)) {
+                decimateM4(getter, m4Indices, xSorted);
+                RenderLine(GetterIndexed<_Getter>(getter, m4Indices.data(), (int)m4Indices.size()), flags, s);
+            } else if (cull) {
+                GetterRange<_Getter> visible = visibleSamples(getter, true);
+                if (visible.Count > 1) {
+                    RenderLine(visible, flags, s);
+                }
+            } else {
+                RenderLine(getter, flags, s);
+            }
         }
         // render markers
         if (s.Marker != ImPlotMarker_None) {
+            if (ImHasFlag(flags, ImPlotLineFlags_NoClip)) {
+                PopPlotClipRect();
+                PushPlotClipRect(s.MarkerSize);
+            }
             const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerOutline]);
             const ImU32 col_fill = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerFill]);
-            CustomRenderMarkers<decltype(getter)>(
-                    getter,
-                    s.Marker,
-                    s.MarkerSize,
-                    s.RenderMarkerFill, 
-                    col_fill,
-                    s.RenderMarkerLine,
-                    col_line,
-                    s.MarkerWeight);
+            GetterRange<_Getter> visible = visibleSamples(getter, xSorted);
+            RenderMarkersSprited<GetterRange<_Getter>>(visible, s.Marker, s.MarkerSize, s.RenderMarkerFill, col_fill, s.RenderMarkerLine, col_line, s.MarkerWeight);
         }
-        
-        ImPlot::EndItem();
+        EndItem();
+    }
+}
+
+template <typename _Getter>
+void PlotLineDecimatedEx(const char* label_id, const _Getter& getter, ImPlotLineFlags flags, bool decimate, bool xSorted) {
+    PlotLineDecimatedEx(label_id, getter, Fitter1<_Getter>(getter), flags, decimate, xSorted);
+}
+
+/**
+ * Same as PlotScatterEx, but only markers of visible samples are transformed
+ * if x is sorted.
+ */
+template <typename _Getter, typename _Fitter>
+void PlotScatterCulledEx(const char* label_id, const _Getter& getter, const _Fitter& fitter, ImPlotScatterFlags flags, bool xSorted, bool dedup = false) {
+    if (BeginItemEx(label_id, fitter, flags, ImPlotCol_MarkerOutline)) {
+        if (getter.Count <= 0) {
+            EndItem();
+            return;
+        }
+        const ImPlotNextItemData& s = GetItemData();
+        ImPlotMarker marker = s.Marker == ImPlotMarker_None ? ImPlotMarker_Circle : s.Marker;
+        if (ImHasFlag(flags, ImPlotScatterFlags_NoClip)) {
+            PopPlotClipRect();
+            PushPlotClipRect(s.MarkerSize);
+        }
+        const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerOutline]);
+        const ImU32 col_fill = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerFill]);
+        GetterRange<_Getter> visible = visibleSamples(getter, xSorted);
+        if (dedup) {
+            using DedupGetter = GetterIndexed<GetterRange<_Getter>>;
+            dedupPixels(visible, nullptr, dedupIndices);
+            RenderMarkersSprited<DedupGetter>(DedupGetter(visible, dedupIndices.data(), (int)dedupIndices.size()), marker, s.MarkerSize, s.RenderMarkerFill, col_fill, s.RenderMarkerLine, col_line, s.MarkerWeight);
+        } else {
+            RenderMarkersSprited<GetterRange<_Getter>>(visible, marker, s.MarkerSize, s.RenderMarkerFill, col_fill, s.RenderMarkerLine, col_line, s.MarkerWeight);
+        }
+        EndItem();
+    }
+}
+
+template <typename _Getter>
+void PlotScatterCulledEx(const char* label_id, const _Getter& getter, ImPlotScatterFlags flags, bool xSorted, bool dedup = false) {
+    PlotScatterCulledEx(label_id, getter, Fitter1<_Getter>(getter), flags, xSorted, dedup);
+}
+
+/**
+ * Fits y only, for items which share x with an item that was already fitted.
+ */
+template <typename _Getter>
+struct FitterSharedX {
+    FitterSharedX(const _Getter& getter) : Getter(getter) { }
+    void Fit(ImPlotAxis& x_axis, ImPlotAxis& y_axis) const {
+        for (int i = 0; i < Getter.Count; ++i) {
+            ImPlotPoint p = Getter(i);
+            y_axis.ExtendFitWith(x_axis, p.y, p.x);
+        }
+    }
+    const _Getter& Getter;
+};
+
+/**
+ * Shaded bands around a line, the bounds are computed on the fly
+ * from the line's samples and per sample offsets.
+ */
+
+static std::vector<int> bandIndices;
+
+template <typename _Getter>
+struct GetterOffsetY {
+    GetterOffsetY(const _Getter& getter, const double* offsets, double sign, int count) :
+        Getter(getter),
+        Offsets(offsets),
+        Sign(sign),
+        Count(ImMin(getter.Count, count))
+    { }
+    template <typename I> IMPLOT_INLINE ImPlotPoint operator()(I idx) const {
+        ImPlotPoint p = Getter(idx);
+        p.y += Sign * Offsets[idx];
+        return p;
+    }
+    const _Getter& Getter;
+    const double* Offsets;
+    const double Sign;
+    const int Count;
+};
+
+/**
+ * Same as PlotShadedEx, but culled and decimated like the line it belongs to.
+ * Both bounds keep the M4 samples of either, so that no extremum is lost.
+ */
+template <typename _Getter1, typename _Getter2>
+void PlotBandEx(const char* label_id, const _Getter1& getter1, const _Getter2& getter2, ImPlotShadedFlags flags, bool decimate, bool xSorted) {
+    if (BeginItemEx(label_id, Fitter2<_Getter1,_Getter2>(getter1, getter2), flags, ImPlotCol_Fill)) {
+        const int count = ImMin(getter1.Count, getter2.Count);
+        const ImPlotNextItemData& s = GetItemData();
+        if (s.RenderFill && count > 1) {
+            const ImU32 col = ImGui::GetColorU32(s.Colors[ImPlotCol_Fill]);
+            if (decimate && shouldDecimate(count, ImPlotLineFlags_None)) {
+                decimateM4(getter1, m4Indices, xSorted);
+                decimateM4(getter2, bandIndices, xSorted);
+                const size_t mid = m4Indices.size();
+                m4Indices.insert(m4Indices.end(), bandIndices.begin(), bandIndices.end());
+                std::inplace_merge(m4Indices.begin(), m4Indices.begin() + mid, m4Indices.end());
+                m4Indices.erase(std::unique(m4Indices.begin(), m4Indices.end()), m4Indices.end());
+                const int n = (int)m4Indices.size();
+                RenderPrimitives2<RendererShaded>(
+                        GetterIndexed<_Getter1>(getter1, m4Indices.data(), n),
+                        GetterIndexed<_Getter2>(getter2, m4Indices.data(), n),
+                        col);
+            } else {
+                GetterRange<_Getter1> visible1 = visibleSamples(getter1, xSorted);
+                GetterRange<_Getter2> visible2(getter2, visible1.First, visible1.Count);
+                if (visible1.Count > 1) {
+                    RenderPrimitives2<RendererShaded>(visible1, visible2, col);
+                }
+            }
+        }
+        EndItem();
+    }
+}
+
+/**
+ * Data access
+ *
+ * The plot arrays are read in place with their native type and stride.
+ * If x and y share a type, typed indexers are used directly.
+ * Otherwise (or for datetime values) the type is resolved per sample.
+ */
+
+struct IndexerAny {
+    IndexerAny(const PlotArray& array) :
+        Data((const unsigned char*)array.data),
+        Type(array.type),
+        Stride(array.stride),
+        TimeScale(array.timeScale)
+    { }
+    template <typename I> IMPLOT_INLINE double operator()(I idx) const {
+        const unsigned char* p = Data + (ptrdiff_t)idx * Stride;
+        switch (Type) {
+            case ImGuiDataType_S8     : return *(const ImS8*)p;
+            case ImGuiDataType_U8     : return *(const ImU8*)p;
+            case ImGuiDataType_S16    : return *(const ImS16*)p;
+            case ImGuiDataType_U16    : return *(const ImU16*)p;
+            case ImGuiDataType_S32    : return *(const ImS32*)p;
+            case ImGuiDataType_U32    : return *(const ImU32*)p;
+            case ImGuiDataType_S64    : return readS64(*(const ImS64*)p);
+            case ImGuiDataType_U64    : return (double)*(const ImU64*)p;
+            case ImGuiDataType_Float  : return *(const float*)p;
+            case ImGuiDataType_Double : return *(const double*)p;
+        }
+        return 0.0;
+    }
+    IMPLOT_INLINE double readS64(ImS64 v) const {
+        if (TimeScale == 0.0) {
+            return (double)v;
+        }
+        // NaT is the smallest int64
+        return v == IM_S64_MIN ? NAN : v * TimeScale;
+    }
+    const unsigned char* Data;
+    const ImGuiDataType Type;
+    const int Stride;
+    const double TimeScale;
+};
+
+/**
+ * Like IndexerIdx, but with a signed byte stride. IndexerIdx multiplies its
+ * stride as size_t, so reversed views would only work by pointer wrap-around.
+ */
+template <typename T>
+struct IndexerStrided {
+    IndexerStrided(const T* data, int stride) :
+        Data((const unsigned char*)data),
+        Stride(stride)
+    { }
+    template <typename I> IMPLOT_INLINE double operator()(I idx) const {
+        return (double)*(const T*)(Data + (ptrdiff_t)idx * Stride);
     }
+    const unsigned char* Data;
+    const int Stride;
+};
+
+template <typename T>
+IndexerStrided<T> makeIndexer(const PlotArray& array) {
+    return IndexerStrided<T>((const T*)array.data, array.stride);
+}
+
+template <typename T, typename F>
+void callWithIndexer(const PlotArray& array, F& f) {
+    f(makeIndexer<T>(array));
+}
+
+template <typename T, typename F>
+void callWithGetter(const PlotArrayInfo& pai, F& f) {
+    const int count = (int)pai.count;
+    f(GetterXY<IndexerStrided<T>, IndexerStrided<T>>(
+                makeIndexer<T>(pai.x),
+                makeIndexer<T>(pai.y),
+                count));
+}
+
+template <typename T, typename F>
+void callWithLinearGetter(const PlotArrayInfo& pai, F& f) {
+    const int count = (int)pai.count;
+    f(GetterXY<IndexerLin, IndexerStrided<T>>(
+                IndexerLin(pai.dx, pai.x0),
+                makeIndexer<T>(pai.y),
+                count));
+}
+
+/**
+ * Calls f with an indexer reading the given array.
+ */
+template <typename F>
+void dispatchIndexer(const PlotArray& array, F&& f) {
+    if (array.timeScale == 0.0) {
+        switch (array.type) {
+            case ImGuiDataType_S8     : callWithIndexer<ImS8>(array, f); return;
+            case ImGuiDataType_U8     : callWithIndexer<ImU8>(array, f); return;
+            case ImGuiDataType_S16    : callWithIndexer<ImS16>(array, f); return;
+            case ImGuiDataType_U16    : callWithIndexer<ImU16>(array, f); return;
+            case ImGuiDataType_S32    : callWithIndexer<ImS32>(array, f); return;
+            case ImGuiDataType_U32    : callWithIndexer<ImU32>(array, f); return;
+            case ImGuiDataType_S64    : callWithIndexer<ImS64>(array, f); return;
+            case ImGuiDataType_U64    : callWithIndexer<ImU64>(array, f); return;
+            case ImGuiDataType_Float  : callWithIndexer<float>(array, f); return;
+            case ImGuiDataType_Double : callWithIndexer<double>(array, f); return;
+        }
+    }
+    f(IndexerAny(array));
+}
+
+/**
+ * Calls f with an indexer for the x values of the given plot data.
+ */
+template <typename F>
+void dispatchXIndexer(const PlotArrayInfo& pai, F&& f) {
+    if (pai.linearX) {
+        f(IndexerLin(pai.dx, pai.x0));
+    } else {
+        dispatchIndexer(pai.x, f);
+    }
+}
+
+/**
+ * Calls f with a getter reading the x and y arrays of the given plot data.
+ */
+template <typename F>
+void dispatchGetter(const PlotArrayInfo& pai, F&& f) {
+    if (pai.linearX) {
+        if (pai.y.timeScale == 0.0) {
+            switch (pai.y.type) {
+                case ImGuiDataType_S8     : callWithLinearGetter<ImS8>(pai, f); return;
+                case ImGuiDataType_U8     : callWithLinearGetter<ImU8>(pai, f); return;
+                case ImGuiDataType_S16    : callWithLinearGetter<ImS16>(pai, f); return;
+                case ImGuiDataType_U16    : callWithLinearGetter<ImU16>(pai, f); return;
+                case ImGuiDataType_S32    : callWithLinearGetter<ImS32>(pai, f); return;
+                case ImGuiDataType_U32    : callWithLinearGetter<ImU32>(pai, f); return;
+                case ImGuiDataType_S64    : callWithLinearGetter<ImS64>(pai, f); return;
+                case ImGuiDataType_U64    : callWithLinearGetter<ImU64>(pai, f); return;
+                case ImGuiDataType_Float  : callWithLinearGetter<float>(pai, f); return;
+                case ImGuiDataType_Double : callWithLinearGetter<double>(pai, f); return;
+            }
+        }
+        const int count = (int)pai.count;
+        f(GetterXY<IndexerLin, IndexerAny>(IndexerLin(pai.dx, pai.x0), IndexerAny(pai.y), count));
+        return;
+    }
+    if (pai.x.type == pai.y.type
+            && pai.x.timeScale == 0.0
+            && pai.y.timeScale == 0.0) {
+        switch (pai.x.type) {
+            case ImGuiDataType_S8     : callWithGetter<ImS8>(pai, f); return;
+            case ImGuiDataType_U8     : callWithGetter<ImU8>(pai, f); return;
+            case ImGuiDataType_S16    : callWithGetter<ImS16>(pai, f); return;
+            case ImGuiDataType_U16    : callWithGetter<ImU16>(pai, f); return;
+            case ImGuiDataType_S32    : callWithGetter<ImS32>(pai, f); return;
+            case ImGuiDataType_U32    : callWithGetter<ImU32>(pai, f); return;
+            case ImGuiDataType_S64    : callWithGetter<ImS64>(pai, f); return;
+            case ImGuiDataType_U64    : callWithGetter<ImU64>(pai, f); return;
+            case ImGuiDataType_Float  : callWithGetter<float>(pai, f); return;
+            case ImGuiDataType_Double : callWithGetter<double>(pai, f); return;
+        }
+    }
+    const int count = (int)pai.count;
+    f(GetterXY<IndexerAny, IndexerAny>(IndexerAny(pai.x), IndexerAny(pai.y), count));
+}
+
+template <typename _Indexer>
+void PlotInfLinesEx(const char* label_id, const _Indexer& indexer, int count, ImPlotInfLinesFlags flags) {
+    const ImPlotRect lims = GetPlotLimits(IMPLOT_AUTO,IMPLOT_AUTO);
+    if (ImHasFlag(flags, ImPlotInfLinesFlags_Horizontal)) {
+        GetterXY<IndexerConst,_Indexer> getter_min(IndexerConst(lims.X.Min),indexer,count);
+        GetterXY<IndexerConst,_Indexer> getter_max(IndexerConst(lims.X.Max),indexer,count);
+        if (BeginItemEx(label_id, FitterY<GetterXY<IndexerConst,_Indexer>>(getter_min), flags, ImPlotCol_Line)) {
+            if (count <= 0) {
+                EndItem();
+                return;
+            }
+            const ImPlotNextItemData& s = GetItemData();
+            const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
+            if (s.RenderLine)
+                RenderPrimitives2<RendererLineSegments2>(getter_min, getter_max, col_line, s.LineWeight);
+            EndItem();
+        }
+    }
+    else {
+        GetterXY<_Indexer,IndexerConst> get_min(indexer,IndexerConst(lims.Y.Min),count);
+        GetterXY<_Indexer,IndexerConst> get_max(indexer,IndexerConst(lims.Y.Max),count);
+        if (BeginItemEx(label_id, FitterX<GetterXY<_Indexer,IndexerConst>>(get_min), flags, ImPlotCol_Line)) {
+            if (count <= 0) {
+                EndItem();
+                return;
+            }
+            const ImPlotNextItemData& s = GetItemData();
+            const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
+            if (s.RenderLine)
+                RenderPrimitives2<RendererLineSegments2>(get_min, get_max, col_line, s.LineWeight);
+            EndItem();
+        }
+    }
+}
+
+/**
+ * Fit bounds cache
+ *
+ * Fitting the axes reads every sample. For data that does not change,
+ * the bounds are cached by the identity of the arrays and a version,
+ * which has to be bumped by the user whenever the data is modified.
+ */
+
+struct FitKey {
+    const void* xData;
+    const void* yData;
+    ImGuiDataType xType;
+    ImGuiDataType yType;
+    int xStride;
+    int yStride;
+    size_t count;
+    bool linearX;
+    double x0;
+    double dx;
+    int64_t version;
+
+    bool operator==(const FitKey& o) const {
+        return xData == o.xData && yData == o.yData
+            && xType == o.xType && yType == o.yType
+            && xStride == o.xStride && yStride == o.yStride
+            && count == o.count && linearX == o.linearX
+            && x0 == o.x0 && dx == o.dx && version == o.version;
+    }
+};
+
+struct FitKeyHash {
+    size_t operator()(const FitKey& k) const {
+        size_t h = std::hash<const void*>()(k.xData);
+        for (size_t v : {std::hash<const void*>()(k.yData),
+                         std::hash<size_t>()(k.count),
+                         std::hash<int64_t>()(k.version),
+                         (size_t)(k.xStride * 31 + k.yStride)}) {
+            h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+struct FitBounds {
+    ImPlotRect rect;
+    bool xSorted;
+};
+
+static const size_t FIT_CACHE_SIZE = 1024;
+static std::unordered_map<FitKey, FitBounds, FitKeyHash> fitCache;
+
+template <typename T>
+void scanBoundsSimd(const T* data, int count, double& lo, double& hi, bool* sorted);
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+template <>
+void scanBoundsSimd<double>(const double* data, int count, double& lo, double& hi, bool* sorted) {
+
+    const __m128d inf = _mm_set1_pd(INFINITY);
+    const __m128d negInf = _mm_set1_pd(-INFINITY);
+    const __m128d absMask = _mm_castsi128_pd(_mm_set_epi32(0x7fffffff, -1, 0x7fffffff, -1));
+
+    __m128d vLo = inf;
+    __m128d vHi = negInf;
+    __m128d ordered = _mm_cmpeq_pd(inf, inf);
+
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(data + i);
+        // NaN and inf do not count, like in ImPlotAxis::ExtendFit
+        __m128d finite = _mm_cmplt_pd(_mm_and_pd(v, absMask), inf);
+        vLo = _mm_min_pd(vLo, _mm_or_pd(_mm_and_pd(finite, v), _mm_andnot_pd(finite, inf)));
+        vHi = _mm_max_pd(vHi, _mm_or_pd(_mm_and_pd(finite, v), _mm_andnot_pd(finite, negInf)));
+        if (sorted != nullptr && i + 2 < count) {
+            ordered = _mm_and_pd(ordered, _mm_cmple_pd(v, _mm_loadu_pd(data + i + 1)));
+        }
+    }
+
+    double l[2], h[2];
+    _mm_storeu_pd(l, vLo);
+    _mm_storeu_pd(h, vHi);
+    lo = ImMin(lo, ImMin(l[0], l[1]));
+    hi = ImMax(hi, ImMax(h[0], h[1]));
+
+    if (sorted != nullptr) {
+        *sorted = *sorted && _mm_movemask_pd(ordered) == 0x3;
+    }
+
+    for (; i < count; ++i) {
+        double v = data[i];
+        if (!ImNanOrInf(v)) {
+            lo = ImMin(lo, v);
+            hi = ImMax(hi, v);
+        }
+    }
+    // pairs ending in the tail
+    if (sorted != nullptr) {
+        for (int k = ImMax(i - 2, 1); k < count; ++k) {
+            *sorted = *sorted && data[k - 1] <= data[k];
+        }
+    }
+}
+
+template <>
+void scanBoundsSimd<float>(const float* data, int count, double& lo, double& hi, bool* sorted) {
+
+    const __m128 inf = _mm_set1_ps(INFINITY);
+    const __m128 negInf = _mm_set1_ps(-INFINITY);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    __m128 vLo = inf;
+    __m128 vHi = negInf;
+    __m128 ordered = _mm_cmpeq_ps(inf, inf);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(data + i);
+        __m128 finite = _mm_cmplt_ps(_mm_and_ps(v, absMask), inf);
+        vLo = _mm_min_ps(vLo, _mm_or_ps(_mm_and_ps(finite, v), _mm_andnot_ps(finite, inf)));
+        vHi = _mm_max_ps(vHi, _mm_or_ps(_mm_and_ps(finite, v), _mm_andnot_ps(finite, negInf)));
+        if (sorted != nullptr && i + 4 < count) {
+            ordered = _mm_and_ps(ordered, _mm_cmple_ps(v, _mm_loadu_ps(data + i + 1)));
+        }
+    }
+
+    float l[4], h[4];
+    _mm_storeu_ps(l, vLo);
+    _mm_storeu_ps(h, vHi);
+    lo = ImMin(lo, (double)ImMin(ImMin(l[0], l[1]), ImMin(l[2], l[3])));
+    hi = ImMax(hi, (double)ImMax(ImMax(h[0], h[1]), ImMax(h[2], h[3])));
+
+    if (sorted != nullptr) {
+        *sorted = *sorted && _mm_movemask_ps(ordered) == 0xf;
+    }
+
+    for (; i < count; ++i) {
+        float v = data[i];
+        if (!ImNanOrInf(v)) {
+            lo = ImMin(lo, (double)v);
+            hi = ImMax(hi, (double)v);
+        }
+    }
+    if (sorted != nullptr) {
+        for (int k = ImMax(i - 4, 1); k < count; ++k) {
+            *sorted = *sorted && data[k - 1] <= data[k];
+        }
+    }
+}
+#endif
+
+/**
+ * Finds the bounds of the finite values of an array and optionally,
+ * whether it is in ascending order.
+ */
+void scanBounds(const PlotArray& array, int count, double& lo, double& hi, bool* sorted) {
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    if (array.type == ImGuiDataType_Double && array.stride == sizeof(double)) {
+        scanBoundsSimd((const double*)array.data, count, lo, hi, sorted);
+        return;
+    }
+    if (array.type == ImGuiDataType_Float && array.stride == sizeof(float)) {
+        scanBoundsSimd((const float*)array.data, count, lo, hi, sorted);
+        return;
+    }
+#endif
+
+    dispatchIndexer(array, [&](const auto& indexer) {
+        double prev = -INFINITY;
+        for (int i = 0; i < count; ++i) {
+            double v = indexer(i);
+            if (!ImNanOrInf(v)) {
+                lo = ImMin(lo, v);
+                hi = ImMax(hi, v);
+            }
+            if (sorted != nullptr) {
+                *sorted = *sorted && prev <= v;
+                prev = v;
+            }
+        }
+    });
+}
+
+FitKey fitKey(const PlotArrayInfo& pai, int64_t version) {
+
+    return {
+        pai.linearX ? nullptr : pai.x.data,
+        pai.y.data,
+        pai.x.type,
+        pai.y.type,
+        pai.x.stride,
+        pai.y.stride,
+        pai.count,
+        pai.linearX,
+        pai.x0,
+        pai.dx,
+        version
+    };
+}
+
+static FitBounds scanFitBounds(const PlotArrayInfo& pai) {
+
+    const int count = (int)pai.count;
+
+    FitBounds b;
+    b.rect = ImPlotRect(INFINITY, -INFINITY, INFINITY, -INFINITY);
+    b.xSorted = true;
+
+    if (pai.linearX) {
+        double last = pai.x0 + (count - 1) * pai.dx;
+        b.rect.X = ImPlotRange(ImMin(pai.x0, last), ImMax(pai.x0, last));
+        b.xSorted = pai.dx > 0.0;
+    } else {
+        scanBounds(pai.x, count, b.rect.X.Min, b.rect.X.Max, &b.xSorted);
+    }
+    scanBounds(pai.y, count, b.rect.Y.Min, b.rect.Y.Max, nullptr);
+
+    return b;
+}
+
+void computeBounds(PlotArrayInfo& pai) {
+
+    if (pai.count == 0) {
+        return;
+    }
+
+    FitBounds b = scanFitBounds(pai);
+
+    pai.hasBounds = true;
+    pai.bounds = b.rect;
+    pai.xSorted = pai.xSorted || b.xSorted;
+}
+
+void cacheBounds(PlotArrayInfo& pai, int64_t version) {
+
+    if (version < 0 || pai.count == 0) {
+        return;
+    }
+
+    FitKey key = fitKey(pai, version);
+
+    auto it = fitCache.find(key);
+
+    if (it == fitCache.end()) {
+        if (fitCache.size() >= FIT_CACHE_SIZE) {
+            fitCache.clear();
+        }
+
+        it = fitCache.emplace(key, scanFitBounds(pai)).first;
+    }
+
+    pai.hasBounds = true;
+    pai.bounds = it->second.rect;
+    pai.xSorted = pai.xSorted || it->second.xSorted;
+}
+
+/**
+ * Fits the cached bounds of an item instead of reading all its samples.
+ */
+template <typename _Getter>
+struct FitterBounds {
+    FitterBounds(const _Getter& getter, const ImPlotRect& bounds) :
+        Getter(getter),
+        Bounds(bounds)
+    { }
+    void Fit(ImPlotAxis& x_axis, ImPlotAxis& y_axis) const {
+        // range constrained fits depend on the other axis, those need all samples
+        bool constrained = ImHasFlag(x_axis.Flags, ImPlotAxisFlags_RangeFit)
+            || ImHasFlag(y_axis.Flags, ImPlotAxisFlags_RangeFit)
+            || Bounds.X.Min < x_axis.ConstraintRange.Min || Bounds.X.Max > x_axis.ConstraintRange.Max
+            || Bounds.Y.Min < y_axis.ConstraintRange.Min || Bounds.Y.Max > y_axis.ConstraintRange.Max;
+        if (constrained) {
+            Fitter1<_Getter>(Getter).Fit(x_axis, y_axis);
+            return;
+        }
+        x_axis.ExtendFit(Bounds.X.Min);
+        x_axis.ExtendFit(Bounds.X.Max);
+        y_axis.ExtendFit(Bounds.Y.Min);
+        y_axis.ExtendFit(Bounds.Y.Max);
+    }
+    const _Getter& Getter;
+    const ImPlotRect Bounds;
+};
+
+void plotLine(
+        const char* label,
+        PlotArrayInfo& pai,
+        ImPlotLineFlags flags,
+        bool decimate) {
+
+    dispatchGetter(pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+        if (pai.hasBounds) {
+            PlotLineDecimatedEx(label, getter, FitterBounds<G>(getter, pai.bounds), flags, decimate, pai.xSorted);
+        } else {
+            PlotLineDecimatedEx(label, getter, flags, decimate, pai.xSorted);
+        }
+    });
+}
+
+void plotScatter(
+        const char* label,
+        PlotArrayInfo& pai,
+        ImPlotScatterFlags flags,
+        bool dedup) {
+
+    dispatchGetter(pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+        if (pai.hasBounds) {
+            PlotScatterCulledEx(label, getter, FitterBounds<G>(getter, pai.bounds), flags, pai.xSorted, dedup);
+        } else {
+            PlotScatterCulledEx(label, getter, flags, pai.xSorted, dedup);
+        }
+    });
+}
+
+void plotMany(
+        const std::vector<std::string>& labels,
+        PlotArrayInfo& pai,
+        size_t rows,
+        ptrdiff_t rowStride,
+        const std::vector<ImVec4>& colors,
+        bool line,
+        float lineWeight,
+        ImPlotMarker marker,
+        float markerSize,
+        float markerWeight,
+        ImPlotLineFlags flags,
+        bool decimate) {
+
+    PlotArrayInfo row = pai;
+    bool xFitted = false;
+
+    for (size_t i = 0; i < rows; ++i) {
+
+        row.y.data = (const uint8_t*)pai.y.data + (ptrdiff_t)i * rowStride;
+
+        ImVec4 color = colors.empty() ? IMPLOT_AUTO_COL : colors[i % colors.size()];
+        SetNextLineStyle(color, lineWeight);
+        SetNextMarkerStyle(marker, markerSize, color, markerWeight, color);
+
+        dispatchGetter(row, [&](const auto& getter) {
+            using G = std::decay_t<decltype(getter)>;
+            const char* label = labels[i].c_str();
+
+            // all rows share x, so it only has to be fitted by the first shown row
+            if (!xFitted) {
+                if (line) {
+                    PlotLineDecimatedEx(label, getter, Fitter1<G>(getter), flags, decimate, row.xSorted);
+                } else {
+                    PlotScatterCulledEx(label, getter, Fitter1<G>(getter), flags, row.xSorted);
+                }
+            } else {
+                if (line) {
+                    PlotLineDecimatedEx(label, getter, FitterSharedX<G>(getter), flags, decimate, row.xSorted);
+                } else {
+                    PlotScatterCulledEx(label, getter, FitterSharedX<G>(getter), flags, row.xSorted);
+                }
+            }
+        });
+
+        // hidden items are not fitted at all
+        ImPlotItem* item = GetItem(labels[i].c_str());
+        xFitted = xFitted || (item != nullptr && item->Show);
+    }
+}
+
+void plotShaded(
+        const char* label,
+        PlotArrayInfo& pai,
+        const double* lower,
+        const double* upper,
+        size_t count,
+        ImPlotShadedFlags flags,
+        bool decimate) {
+
+    const int n = (int)std::min(count, pai.count);
+
+    dispatchGetter(pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+        GetterOffsetY<G> getter1(getter, lower, -1.0, n);
+        GetterOffsetY<G> getter2(getter, upper, 1.0, n);
+        PlotBandEx(label, getter1, getter2, flags, decimate, pai.xSorted);
+    });
+}
+
+void plotBars(
+        const char* label,
+        PlotArrayInfo& pai,
+        double barSize,
+        ImPlotBarsFlags flags) {
+
+    dispatchGetter(pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+        if (ImHasFlag(flags, ImPlotBarsFlags_Horizontal)) {
+            PlotBarsHEx(label, getter, GetterOverrideX<G>(getter, 0), barSize, flags);
+        } else {
+            PlotBarsVEx(label, getter, GetterOverrideY<G>(getter, 0), barSize, flags);
+        }
+    });
+}
+
+void plotInfLines(
+        const char* label,
+        PlotArray& values,
+        size_t count,
+        ImPlotInfLinesFlags flags) {
+
+    dispatchIndexer(values, [&](const auto& indexer) {
+        PlotInfLinesEx(label, indexer, (int)count, flags);
+    });
+}
+
+template <typename T>
+void plotStreamAs(
+        const char* label,
+        const StreamSeries& stream,
+        int count,
+        bool xSorted,
+        bool line,
+        ImPlotLineFlags flags,
+        bool decimate) {
+
+    // the snapshot is already unrolled, sample 0 is the oldest one
+    const T* xData = (const T*)stream.xSnapshot.data();
+    const T* yData = (const T*)stream.ySnapshot.data();
+
+    GetterXY<IndexerIdx<T>, IndexerIdx<T>> getter(
+            IndexerIdx<T>(xData, count),
+            IndexerIdx<T>(yData, count),
+            count);
+
+    if (line) {
+        PlotLineDecimatedEx(label, getter, flags, decimate, xSorted);
+    } else {
+        PlotScatterCulledEx(label, getter, flags, xSorted);
+    }
+}
+
+void plotStream(
+        const char* label,
+        StreamSeries& stream,
+        bool line,
+        ImPlotLineFlags flags,
+        bool decimate) {
+
+    // the ring is copied under the lock and plotted from the copy, so
+    // producers only wait for the copy and never for the render, which
+    // releases the GIL
+    int count = 0;
+    bool xSorted = true;
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        const size_t bytes = stream.count * (stream.xData.size() / stream.capacity);
+        stream.xSnapshot.resize(bytes);
+        stream.ySnapshot.resize(bytes);
+        stream.unroll(stream.xSnapshot.data(), stream.ySnapshot.data());
+        count = (int)stream.count;
+        xSorted = stream.xSorted;
+    }
+
+    switch (stream.type) {
+        case ImGuiDataType_S8: plotStreamAs<int8_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_U8: plotStreamAs<uint8_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_S16: plotStreamAs<int16_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_U16: plotStreamAs<uint16_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_S32: plotStreamAs<int32_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_U32: plotStreamAs<uint32_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_S64: plotStreamAs<int64_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_U64: plotStreamAs<uint64_t>(label, stream, count, xSorted, line, flags, decimate); break;
+        case ImGuiDataType_Float: plotStreamAs<float>(label, stream, count, xSorted, line, flags, decimate); break;
+        default: plotStreamAs<double>(label, stream, count, xSorted, line, flags, decimate); break;
+    }
+}
+
+/**
+ * Level of detail pyramid
+ *
+ * The lowest level reduces buckets of LOD_BASE_BUCKET samples to the index
+ * of their minimum and maximum, every further level merges LOD_BRANCHING
+ * buckets of the previous one. A frame reads the coarsest level that still
+ * has two buckets per pixel column and decimates the result with M4.
+ */
+
+static const int LOD_BASE_BUCKET = 64;
+static const int LOD_BRANCHING = 4;
+
+static std::vector<int> lodIndices;
+
+// NaN test on the bits, -ffast-math folds ImNan() and v != v away
+static inline bool isNanBits(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x7fffffffffffffffull) > 0x7ff0000000000000ull;
+}
+
+void buildLod(LodSeries& lod) {
+
+    const int count = (int)lod.pai.count;
+
+    // visible buckets are found by binary search, which needs ascending x
+    bool sorted = true;
+    if (lod.pai.linearX) {
+        sorted = lod.pai.dx > 0;
+    } else {
+        dispatchIndexer(lod.pai.x, [&](const auto& x) {
+            for (int i = 1; i < count && sorted && !lod.cancel; ++i) {
+                sorted = x(i - 1) <= x(i);
+            }
+        });
+    }
+
+    if (!sorted || count < 2 * LOD_BASE_BUCKET) {
+        lod.ready = true;
+        return;
+    }
+
+    dispatchIndexer(lod.pai.y, [&](const auto& y) {
+
+        // lowest level from the samples
+        const int buckets = (count + LOD_BASE_BUCKET - 1) / LOD_BASE_BUCKET;
+        std::vector<int> level(2 * buckets);
+
+        for (int b = 0; b < buckets && !lod.cancel; ++b) {
+            const int begin = b * LOD_BASE_BUCKET;
+            const int end = ImMin(begin + LOD_BASE_BUCKET, count);
+            int iMin = begin;
+            int iMax = begin;
+            double yMin = INFINITY;
+            double yMax = -INFINITY;
+            for (int i = begin; i < end; ++i) {
+                double v = y(i);
+                if (v < yMin) {
+                    yMin = v;
+                    iMin = i;
+                }
+                if (v > yMax) {
+                    yMax = v;
+                    iMax = i;
+                }
+            }
+            level[2 * b] = iMin;
+            level[2 * b + 1] = iMax;
+        }
+
+        lod.levels.push_back(std::move(level));
+
+        // merge buckets until only a handful is left
+        while (lod.levels.back().size() > 2 * LOD_BRANCHING && !lod.cancel) {
+            const std::vector<int>& prev = lod.levels.back();
+            const int prevBuckets = (int)prev.size() / 2;
+            const int nextBuckets = (prevBuckets + LOD_BRANCHING - 1) / LOD_BRANCHING;
+            std::vector<int> next(2 * nextBuckets);
+
+            for (int b = 0; b < nextBuckets; ++b) {
+                const int begin = b * LOD_BRANCHING;
+                const int end = ImMin(begin + LOD_BRANCHING, prevBuckets);
+                int iMin = prev[2 * begin];
+                int iMax = prev[2 * begin + 1];
+                for (int c = begin + 1; c < end; ++c) {
+                    if (y(prev[2 * c]) < y(iMin) || isNanBits(y(iMin))) {
+                        iMin = prev[2 * c];
+                    }
+                    if (y(prev[2 * c + 1]) > y(iMax) || isNanBits(y(iMax))) {
+                        iMax = prev[2 * c + 1];
+                    }
+                }
+                next[2 * b] = iMin;
+                next[2 * b + 1] = iMax;
+            }
+
+            lod.levels.push_back(std::move(next));
+        }
+    });
+
+    lod.ready = true;
+}
+
+void plotLod(
+        const char* label,
+        LodSeries& lod,
+        ImPlotLineFlags flags) {
+
+    // plot all samples until the pyramid is ready (or if there is none)
+    if (!lod.ready || lod.levels.empty()) {
+        plotLine(label, lod.pai, flags, true);
+        return;
+    }
+
+    dispatchGetter(lod.pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+
+        ImPlotPlot& plot = *GetCurrentPlot();
+
+        // fitting has to see the whole series
+        int first = 0;
+        int last = getter.Count - 1;
+        if (!plot.FitThisFrame) {
+            visibleRange(getter, first, last);
+        }
+
+        const int visible = last - first + 1;
+        const int minBuckets = 2 * ImMax(1, (int)plot.PlotRect.GetWidth());
+
+        int level = -1;
+        int bucketSize = LOD_BASE_BUCKET;
+        while (level + 1 < (int)lod.levels.size() && visible / bucketSize >= minBuckets) {
+            level += 1;
+            bucketSize *= LOD_BRANCHING;
+        }
+
+        if (level < 0) {
+            PlotLineDecimatedEx(label, getter, flags, true, true);
+            return;
+        }
+
+        bucketSize /= LOD_BRANCHING;
+        const std::vector<int>& buckets = lod.levels[level];
+
+        // extrema of all visible buckets in index order
+        lodIndices.clear();
+        lodIndices.push_back(first);
+        for (int b = first / bucketSize; b <= last / bucketSize; ++b) {
+            int a = buckets[2 * b];
+            int c = buckets[2 * b + 1];
+            for (int i : {ImMin(a, c), ImMax(a, c)}) {
+                if (i > lodIndices.back()) {
+                    lodIndices.push_back(i);
+                }
+            }
+        }
+        if (last > lodIndices.back()) {
+            lodIndices.push_back(last);
+        }
+
+        GetterIndexed<G> indexed(getter, lodIndices.data(), (int)lodIndices.size());
+        PlotLineDecimatedEx(label, indexed, flags, true, true);
+    });
+}
+
+/**
+ * Per point colors
+ *
+ * The custom renderers take packed colors with the layout of IM_COL32, i.e.
+ * RGBA bytes in memory. (N, 4) uint8 arrays and (N,) uint32 views of them
+ * are used as they are, float RGBA arrays are converted once per call.
+ */
+
+static std::vector<ImU32> packedColors;
+
+void packColorsF32(const float* rgba, ImU32* packed, int count) {
+
+    int i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    auto toInt = [&](const float* p) {
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), zero), one);
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half));
+    };
+
+    // four colors at once, same rounding as ImGui::ColorConvertFloat4ToU32
+    for (; i + 4 <= count; i += 4) {
+        const float* p = rgba + 4 * i;
+        __m128i c01 = _mm_packs_epi32(toInt(p), toInt(p + 4));
+        __m128i c23 = _mm_packs_epi32(toInt(p + 8), toInt(p + 12));
+        _mm_storeu_si128((__m128i*)(packed + i), _mm_packus_epi16(c01, c23));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float* p = rgba + 4 * i;
+        packed[i] = ImGui::ColorConvertFloat4ToU32(ImVec4(p[0], p[1], p[2], p[3]));
+    }
+}
+
+static void checkColorCount(py::ssize_t size, size_t count) {
+
+    if (size != (py::ssize_t)count) {
+        std::stringstream ss;
+        ss << "color array size ("
+           << size
+           << ") != number of points ("
+           << count
+           << ")";
+        throw py::value_error(ss.str());
+    }
+}
+
+const ImU32* packColors(py::handle color, size_t count, py::array& holder) {
+
+    py::array array = py::array::ensure(color);
+    if (!array) {
+        throw py::value_error("color has to be an array of per point colors");
+    }
+
+    const char kind = array.dtype().kind();
+    const py::ssize_t size = array.dtype().itemsize();
+
+    const bool packed = kind == 'u'
+        && ((size == 4 && array.ndim() == 1)
+            || (size == 1 && array.ndim() == 2 && array.shape(1) == 4));
+
+    if (packed) {
+        if (size == 4) {
+            holder = array_like<uint32_t>::ensure(array);
+        } else {
+            holder = array_like<uint8_t>::ensure(array);
+        }
+    } else {
+        holder = array_like<float>::ensure(array);
+        if (holder.ndim() != 2 || holder.shape(1) != 4) {
+            throw py::value_error("color array has to be of shape (N, 4), but found "
+                    + shapeToStr(holder));
+        }
+    }
+
+    checkColorCount(holder.shape(0), count);
+
+    if (packed) {
+        return (const ImU32*)holder.data();
+    }
+
+    packedColors.resize(count);
+    packColorsF32((const float*)holder.data(), packedColors.data(), (int)count);
+
+    return packedColors.data();
+}
+
+static ImPlotColormap resolveColormap(ImPlotColormap cmap) {
+
+    if (cmap == IMPLOT_AUTO) {
+        return GImPlot->Style.Colormap;
+    }
+    if (cmap < 0 || cmap >= GImPlot->ColormapData.Count) {
+        throw py::value_error("Invalid colormap " + std::to_string(cmap));
+    }
+
+    return cmap;
+}
+
+// colormaps cannot change once added, so one cached LUT is enough
+static ImU32 colormapLut[256];
+static ImPlotColormap colormapLutId = -1;
+
+const ImU32* getColormapLut(ImPlotColormap cmap) {
+
+    cmap = resolveColormap(cmap);
+
+    if (cmap != colormapLutId) {
+        for (int i = 0; i < 256; ++i) {
+            colormapLut[i] = ImGui::ColorConvertFloat4ToU32(SampleColormap(i / 255.0f, cmap));
+        }
+        colormapLutId = cmap;
+    }
+
+    return colormapLut;
+}
+
+static PlotArray interpretPointValues(py::handle values, py::array& holder, size_t count) {
+
+    holder = toPlotArray(values);
+
+    if (holder.ndim() != 1) {
+        throw py::value_error("per point color values have to be one dimensional, but found "
+                + shapeToStr(holder));
+    }
+    checkColorCount(holder.shape(0), count);
+
+    return interpretPlotArray(holder);
+}
+
+const ImU32* mapColorValues(
+        py::handle values,
+        size_t count,
+        ImPlotColormap cmap,
+        std::optional<double> vmin,
+        std::optional<double> vmax) {
+
+    const ImU32* lut = getColormapLut(cmap);
+
+    py::array holder;
+    PlotArray array = interpretPointValues(values, holder, count);
+
+    packedColors.resize(count);
+
+    dispatchIndexer(array, [&](const auto& v) {
+        const int n = (int)count;
+
+        // unset limits are taken from the finite values
+        double lo = 0.0;
+        double hi = 0.0;
+        if (!vmin || !vmax) {
+            lo = INFINITY;
+            hi = -INFINITY;
+            for (int i = 0; i < n; ++i) {
+                double x = v(i);
+                if (!ImNanOrInf(x)) {
+                    lo = ImMin(lo, x);
+                    hi = ImMax(hi, x);
+                }
+            }
+        }
+        lo = vmin.value_or(lo);
+        hi = vmax.value_or(hi);
+
+        const double scale = hi > lo ? 255.0 / (hi - lo) : 0.0;
+
+        // invalid values become transparent, ImNanOrInf survives -ffast-math
+        for (int i = 0; i < n; ++i) {
+            double t = ((double)v(i) - lo) * scale + 0.5;
+            packedColors[i] = ImNanOrInf(t) ? 0 : lut[(int)ImClamp(t, 0.0, 255.0)];
+        }
+    });
+
+    return packedColors.data();
+}
+
+static std::vector<ImU32> paletteColors;
+
+const ImU32* mapColorIndices(
+        py::handle indices,
+        size_t count,
+        py::handle palette,
+        ImPlotColormap cmap) {
+
+    paletteColors.clear();
+
+    if (palette.is_none()) {
+        cmap = resolveColormap(cmap);
+        for (int i = 0; i < GetColormapSize(cmap); ++i) {
+            paletteColors.push_back(ImGui::ColorConvertFloat4ToU32(GetColormapColor(i, cmap)));
+        }
+    } else {
+        for (py::handle c : palette) {
+            paletteColors.push_back(ImGui::ColorConvertFloat4ToU32(interpretColor(c)));
+        }
+    }
+
+    if (paletteColors.empty()) {
+        throw py::value_error("palette must not be empty");
+    }
+
+    py::array holder;
+    PlotArray array = interpretPointValues(indices, holder, count);
+
+    packedColors.resize(count);
+
+    dispatchIndexer(array, [&](const auto& v) {
+        const int n = (int)count;
+        const int64_t size = (int64_t)paletteColors.size();
+
+        // indices wrap around the palette, the cast of non finite or out
+        // of range indices (e.g. NaT) is undefined, so they are transparent
+        for (int i = 0; i < n; ++i) {
+            const double d = v(i);
+            if (ImNanOrInf(d) || d <= -9.0e18 || d >= 9.0e18) {
+                packedColors[i] = 0;
+                continue;
+            }
+            int64_t k = (int64_t)d % size;
+            packedColors[i] = paletteColors[k < 0 ? k + size : k];
+        }
+    });
+
+    return packedColors.data();
+}
+
+template <typename _Getter, typename _Fitter>
+void customPlotEx(
+        const char* label,
+        const _Getter& getter,
+        const _Fitter& fitter,
+        const ImU32* colors,
+        bool noLine,
+        ImPlotFlags flags,
+        bool decimate,
+        bool xSorted,
+        bool dedup) {
+
+    const int count = getter.Count;
+
+    if (BeginItemEx(
+                label,
+                fitter,
+                flags,
+                ImPlotCol_Line)) {
+
+        const ImPlotNextItemData& s = ImPlot::GetItemData();
+
+        // with sorted x, only the visible samples are transformed
+        using VisibleGetter = GetterRange<_Getter>;
+        VisibleGetter visible = visibleSamples(getter, xSorted);
+        const ImU32* visibleColors = colors + visible.First;
+
+        CustomRendererLineStrip<VisibleGetter>::colors = visibleColors;
+        CustomRendererMarkersFill<VisibleGetter>::colors = visibleColors;
+        CustomRendererMarkersLine<VisibleGetter>::colors = visibleColors;
+
+        if (count > 1 && s.RenderLine && noLine == false) {
+            const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
+            if (decimate && shouldDecimate(count, flags)) {
+                decimateM4(getter, m4Indices, xSorted);
+
+                m4Colors.resize(m4Indices.size());
+                for (size_t i = 0; i < m4Indices.size(); ++i) {
+                    m4Colors[i] = colors[m4Indices[i]];
+                }
+
+                using DecimatedGetter = GetterIndexed<_Getter>;
+                CustomRendererLineStrip<DecimatedGetter>::colors = m4Colors.data();
+
+                RenderPrimitivesParallel<CustomRendererLineStrip>(
+                        DecimatedGetter(getter, m4Indices.data(), (int)m4Indices.size()),
+                        col_line,
+                        s.LineWeight);
+            } else if (visible.Count > 1) {
+                RenderPrimitivesParallel<CustomRendererLineStrip>(visible, col_line, s.LineWeight);
+            }
+        }
+        // render markers
+        if (s.Marker != ImPlotMarker_None) {
+            const ImU32 col_line = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerOutline]);
+            const ImU32 col_fill = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerFill]);
+            if (dedup) {
+                dedupPixels(visible, visibleColors, dedupIndices);
+
+                dedupColors.resize(dedupIndices.size());
+                for (size_t i = 0; i < dedupIndices.size(); ++i) {
+                    dedupColors[i] = visibleColors[dedupIndices[i]];
+                }
+
+                using DedupGetter = GetterIndexed<VisibleGetter>;
+                CustomRendererMarkersFill<DedupGetter>::colors = dedupColors.data();
+                CustomRendererMarkersLine<DedupGetter>::colors = dedupColors.data();
+
+                CustomRenderMarkers<DedupGetter>(
+                        DedupGetter(visible, dedupIndices.data(), (int)dedupIndices.size()),
+                        s.Marker,
+                        s.MarkerSize,
+                        s.RenderMarkerFill,
+                        col_fill,
+                        s.RenderMarkerLine,
+                        col_line,
+                        s.MarkerWeight);
+            } else {
+                CustomRenderMarkers<VisibleGetter>(
+                        visible,
+                        s.Marker,
+                        s.MarkerSize,
+                        s.RenderMarkerFill, 
+                        col_fill,
+                        s.RenderMarkerLine,
+                        col_line,
+                        s.MarkerWeight);
+            }
+        }
+        
+        ImPlot::EndItem();
+    }
+}
+
+void customPlot(
+        const char* label,
+        PlotArrayInfo& pai,
+        const ImU32* colors,
+        bool noLine,
+        ImPlotFlags flags,
+        bool decimate,
+        bool dedup) {
+
+    dispatchGetter(pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+        if (pai.hasBounds) {
+            customPlotEx(label, getter, FitterBounds<G>(getter, pai.bounds), colors, noLine, flags, decimate, pai.xSorted, dedup);
+        } else {
+            customPlotEx(label, getter, Fitter1<G>(getter), colors, noLine, flags, decimate, pai.xSorted, dedup);
+        }
+    });
+}
+
+/**
+ * Hover queries
+ *
+ * The samples of versioned data are sorted into a uniform grid once, so
+ * finding the sample under the cursor only reads the cells around it.
+ * Unversioned data is searched directly, by binary search if x is sorted.
+ */
+
+static const int GRID_POINTS_PER_CELL = 4;
+static const int GRID_MAX_CELLS_PER_AXIS = 2048;
+static const size_t GRID_CACHE_SIZE = 16;
+
+struct PointGrid {
+    ImPlotRect bounds;
+    int cols = 0;
+    int rows = 0;
+    double cellsPerX = 0.0;
+    double cellsPerY = 0.0;
+    // samples of cell c are points[cellStart[c]] ... points[cellStart[c + 1] - 1]
+    std::vector<int> cellStart;
+    std::vector<int> points;
+
+    int col(double x) const {
+        return cell((x - bounds.X.Min) * cellsPerX, cols);
+    }
+    int row(double y) const {
+        return cell((y - bounds.Y.Min) * cellsPerY, rows);
+    }
+    // clamped in double, positions far outside the grid do not fit into an int
+    static int cell(double c, int n) {
+        return c <= 0.0 ? 0 : c >= n - 1 ? n - 1 : (int)c;
+    }
+};
+
+static std::unordered_map<FitKey, std::unique_ptr<PointGrid>, FitKeyHash> gridCache;
+
+template <typename _Getter>
+void buildGrid(const _Getter& getter, PointGrid& grid) {
+
+    const int count = getter.Count;
+
+    grid.bounds = ImPlotRect(INFINITY, -INFINITY, INFINITY, -INFINITY);
+    for (int i = 0; i < count; ++i) {
+        ImPlotPoint p = getter(i);
+        if (ImNanOrInf(p.x) || ImNanOrInf(p.y)) {
+            continue;
+        }
+        grid.bounds.X.Min = ImMin(grid.bounds.X.Min, p.x);
+        grid.bounds.X.Max = ImMax(grid.bounds.X.Max, p.x);
+        grid.bounds.Y.Min = ImMin(grid.bounds.Y.Min, p.y);
+        grid.bounds.Y.Max = ImMax(grid.bounds.Y.Max, p.y);
+    }
+
+    if (grid.bounds.X.Min > grid.bounds.X.Max) {
+        grid.cols = grid.rows = 0;
+        grid.cellStart.assign(1, 0);
+        grid.points.clear();
+        return;
+    }
+
+    const int side = ImClamp((int)std::sqrt((double)count / GRID_POINTS_PER_CELL), 1, GRID_MAX_CELLS_PER_AXIS);
+    grid.cols = side;
+    grid.rows = side;
+    grid.cellsPerX = grid.bounds.X.Size() > 0.0 ? side / grid.bounds.X.Size() : 0.0;
+    grid.cellsPerY = grid.bounds.Y.Size() > 0.0 ? side / grid.bounds.Y.Size() : 0.0;
+
+    // cell of every sample, -1 for non-finite ones
+    std::vector<int> cells(count);
+    const int chunks = ImMax(1, ImMin(parallel::threadCount(), count / 65536));
+
+    parallel::run(chunks, [&](int c) {
+        const int begin = (int)((int64_t)count * c / chunks);
+        const int end = (int)((int64_t)count * (c + 1) / chunks);
+        for (int i = begin; i < end; ++i) {
+            ImPlotPoint p = getter(i);
+            if (ImNanOrInf(p.x) || ImNanOrInf(p.y)) {
+                cells[i] = -1;
+            } else {
+                cells[i] = grid.row(p.y) * grid.cols + grid.col(p.x);
+            }
+        }
+    });
+
+    // counting sort of the samples by cell
+    grid.cellStart.assign((size_t)grid.cols * grid.rows + 1, 0);
+    for (int c : cells) {
+        if (c >= 0) {
+            grid.cellStart[c + 1] += 1;
+        }
+    }
+    for (size_t c = 1; c < grid.cellStart.size(); ++c) {
+        grid.cellStart[c] += grid.cellStart[c - 1];
+    }
+
+    std::vector<int> next(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    grid.points.resize(grid.cellStart.back());
+    for (int i = 0; i < count; ++i) {
+        if (cells[i] >= 0) {
+            grid.points[next[cells[i]]++] = i;
+        }
+    }
+}
+
+static const PointGrid& cachedGrid(const PlotArrayInfo& pai, int64_t version) {
+
+    FitKey key = fitKey(pai, version);
+
+    auto it = gridCache.find(key);
+
+    if (it == gridCache.end()) {
+        if (gridCache.size() >= GRID_CACHE_SIZE) {
+            gridCache.clear();
+        }
+
+        std::unique_ptr<PointGrid> grid(new PointGrid());
+        dispatchGetter(pai, [&](const auto& getter) {
+            py::gil_scoped_release release;
+            buildGrid(getter, *grid);
+        });
+
+        it = gridCache.emplace(key, std::move(grid)).first;
+    }
+
+    return *it->second;
+}
+
+int64_t nearestPoint(
+        const PlotArrayInfo& pai,
+        float pixelRadius,
+        int64_t version,
+        ImAxis xAxisIdx,
+        ImAxis yAxisIdx) {
+
+    IM_ASSERT_USER_ERROR(GImPlot->CurrentPlot != nullptr, "nearest_point() needs to be called between BeginPlot() and EndPlot()!");
+
+    if (pai.count == 0 || !(pixelRadius > 0.0f)) {
+        return -1;
+    }
+
+    ImPlotPlot& plot = *GImPlot->CurrentPlot;
+    const ImPlotAxis& xAxis = plot.Axes[xAxisIdx == IMPLOT_AUTO ? plot.CurrentX : xAxisIdx];
+    const ImPlotAxis& yAxis = plot.Axes[yAxisIdx == IMPLOT_AUTO ? plot.CurrentY : yAxisIdx];
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+    // search window in plot space, axes may be inverted
+    const double xa = xAxis.PixelsToPlot(mouse.x - pixelRadius);
+    const double xb = xAxis.PixelsToPlot(mouse.x + pixelRadius);
+    const double ya = yAxis.PixelsToPlot(mouse.y - pixelRadius);
+    const double yb = yAxis.PixelsToPlot(mouse.y + pixelRadius);
+    const ImPlotRect window(ImMin(xa, xb), ImMax(xa, xb), ImMin(ya, yb), ImMax(ya, yb));
+
+    int64_t best = -1;
+    float bestDist2 = pixelRadius * pixelRadius;
+
+    dispatchGetter(pai, [&](const auto& getter) {
+
+        // of equally distant samples the one with the lowest index wins
+        auto consider = [&](int i) {
+            ImPlotPoint p = getter(i);
+            float dx = xAxis.PlotToPixels(p.x) - mouse.x;
+            float dy = yAxis.PlotToPixels(p.y) - mouse.y;
+            float dist2 = dx * dx + dy * dy;
+            if (dist2 < bestDist2 || (dist2 == bestDist2 && (best < 0 || i < best))) {
+                bestDist2 = dist2;
+                best = i;
+            }
+        };
+
+        if (version >= 0) {
+            const PointGrid& grid = cachedGrid(pai, version);
+            if (grid.cols == 0
+                    || window.X.Max < grid.bounds.X.Min || window.X.Min > grid.bounds.X.Max
+                    || window.Y.Max < grid.bounds.Y.Min || window.Y.Min > grid.bounds.Y.Max) {
+                return;
+            }
+            const int c0 = grid.col(window.X.Min);
+            const int c1 = grid.col(window.X.Max);
+            const int r0 = grid.row(window.Y.Min);
+            const int r1 = grid.row(window.Y.Max);
+            for (int r = r0; r <= r1; ++r) {
+                const int* begin = grid.points.data() + grid.cellStart[r * grid.cols + c0];
+                const int* end = grid.points.data() + grid.cellStart[r * grid.cols + c1 + 1];
+                for (const int* i = begin; i != end; ++i) {
+                    consider(*i);
+                }
+            }
+        } else if (pai.xSorted) {
+            int lo = 0;
+            int hi = getter.Count;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (getter(mid).x < window.X.Min) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            for (int i = lo; i < getter.Count && getter(i).x <= window.X.Max; ++i) {
+                consider(i);
+            }
+        } else {
+            for (int i = 0; i < getter.Count; ++i) {
+                consider(i);
+            }
+        }
+    });
+
+    return best;
+}
+
+/**
+ * Selection
+ *
+ * Indices of the samples inside a rectangle or polygon in plot space. The
+ * samples are tested in parallel chunks with the GIL released, contiguous
+ * float64 data with the SIMD kernels. While a rectangle is dragged, the
+ * previous result of versioned data is filtered instead of scanning again
+ * as long as the rectangle only shrinks.
+ */
+
+static const int SELECT_MIN_CHUNK = 65536;
+
+// per calling thread, as selections run with the GIL released
+static thread_local std::vector<std::vector<int>> selectChunks;
+
+struct RectSelection {
+    FitKey key;
+    ImPlotRect rect;
+    std::vector<int> indices;
+    bool valid = false;
+};
+
+// never held while the GIL is released, which could deadlock
+static std::mutex lastSelectionMutex;
+static RectSelection lastSelection;
+
+IMPLOT_INLINE bool insideRect(const ImPlotRect& rect, const ImPlotPoint& p) {
+    return p.x >= rect.X.Min && p.x <= rect.X.Max && p.y >= rect.Y.Min && p.y <= rect.Y.Max;
+}
+
+// even-odd rule, the polygon is closed implicitly
+bool insidePolygon(const std::vector<ImPlotPoint>& poly, const ImPlotPoint& p) {
+    bool inside = false;
+    for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+        const ImPlotPoint& a = poly[i];
+        const ImPlotPoint& b = poly[j];
+        if ((a.y > p.y) != (b.y > p.y)
+                && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * Calls select(begin, end, out) for parallel chunks of [first, last) and
+ * concatenates the selected indices in order.
+ */
+template <typename F>
+void selectChunked(int first, int last, std::vector<int>& indices, const F& select) {
+
+    const int count = last - first;
+    const int chunks = ImMax(1, ImMin(parallel::threadCount(), count / SELECT_MIN_CHUNK));
+
+    // the workers have to see the buffers of this thread, not their own
+    std::vector<std::vector<int>>& chunkIndices = selectChunks;
+
+    if ((int)chunkIndices.size() < chunks) {
+        chunkIndices.resize(chunks);
+    }
+
+    py::gil_scoped_release release;
+
+    parallel::run(chunks, [&](int c) {
+        const int begin = first + (int)((int64_t)count * c / chunks);
+        const int end = first + (int)((int64_t)count * (c + 1) / chunks);
+        chunkIndices[c].clear();
+        select(begin, end, chunkIndices[c]);
+    });
+
+    size_t total = 0;
+    for (int c = 0; c < chunks; ++c) {
+        total += chunkIndices[c].size();
+    }
+
+    indices.resize(total);
+    size_t offset = 0;
+    for (int c = 0; c < chunks; ++c) {
+        std::copy(chunkIndices[c].begin(), chunkIndices[c].end(), indices.begin() + offset);
+        offset += chunkIndices[c].size();
+    }
+}
+
+/**
+ * Selects the samples inside rect, further filtered by poly if it is not empty.
+ */
+void selectSamples(const PlotArrayInfo& pai, const ImPlotRect& rect, const std::vector<ImPlotPoint>& poly, std::vector<int>& indices) {
+
+    dispatchGetter(pai, [&](const auto& getter) {
+
+        // sorted x bounds the samples to look at
+        int first = 0;
+        int last = getter.Count;
+        if (pai.xSorted) {
+            auto lowerBound = [&](double x, bool inclusive) {
+                int lo = 0;
+                int hi = getter.Count;
+                while (lo < hi) {
+                    int mid = lo + (hi - lo) / 2;
+                    double v = getter(mid).x;
+                    if (v < x || (inclusive && v == x)) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            };
+            first = lowerBound(rect.X.Min, false);
+            last = lowerBound(rect.X.Max, true);
+        }
+
+        if (first >= last) {
+            indices.clear();
+            return;
+        }
+
+        const bool simd = !pai.linearX
+            && pai.x.type == ImGuiDataType_Double && pai.x.stride == sizeof(double) && pai.x.timeScale == 0.0
+            && pai.y.type == ImGuiDataType_Double && pai.y.stride == sizeof(double) && pai.y.timeScale == 0.0;
+
+        const double bounds[4] = {rect.X.Min, rect.Y.Min, rect.X.Max, rect.Y.Max};
+
+        selectChunked(first, last, indices, [&](int begin, int end, std::vector<int>& out) {
+            if (simd) {
+                out.resize(end - begin);
+                int n = kernels::selectInRect(
+                        (const double*)pai.x.data + begin,
+                        (const double*)pai.y.data + begin,
+                        end - begin,
+                        bounds,
+                        out.data());
+                out.resize(n);
+                for (int& i : out) {
+                    i += begin;
+                }
+            } else {
+                for (int i = begin; i < end; ++i) {
+                    if (insideRect(rect, getter(i))) {
+                        out.push_back(i);
+                    }
+                }
+            }
+            if (!poly.empty()) {
+                size_t n = 0;
+                for (int i : out) {
+                    if (insidePolygon(poly, getter(i))) {
+                        out[n++] = i;
+                    }
+                }
+                out.resize(n);
+            }
+        });
+    });
+}
+
+static py::array indexArray(const std::vector<int>& indices) {
+
+    py::array_t<int64_t> result(indices.size());
+    std::copy(indices.begin(), indices.end(), result.mutable_data());
+    return result;
+}
+
+py::array selectInRect(const PlotArrayInfo& pai, ImPlotRect rect, int64_t version, bool incremental) {
+
+    rect = ImPlotRect(ImMin(rect.X.Min, rect.X.Max), ImMax(rect.X.Min, rect.X.Max),
+                      ImMin(rect.Y.Min, rect.Y.Max), ImMax(rect.Y.Min, rect.Y.Max));
+
+    std::vector<int> indices;
+
+    if (pai.count == 0) {
+        return indexArray(indices);
+    }
+
+    // only versioned data is known to be unchanged since the last call
+    const bool reuse = incremental && version >= 0;
+    const FitKey key = fitKey(pai, version);
+
+    bool shrunk = false;
+    if (reuse) {
+        std::lock_guard<std::mutex> lock(lastSelectionMutex);
+        const ImPlotRect& last = lastSelection.rect;
+        shrunk = lastSelection.valid && lastSelection.key == key
+            && rect.X.Min >= last.X.Min && rect.X.Max <= last.X.Max
+            && rect.Y.Min >= last.Y.Min && rect.Y.Max <= last.Y.Max;
+        if (shrunk) {
+            indices.swap(lastSelection.indices);
+            lastSelection.valid = false;
+        }
+    }
+
+    if (shrunk) {
+        dispatchGetter(pai, [&](const auto& getter) {
+            py::gil_scoped_release release;
+            size_t n = 0;
+            for (int i : indices) {
+                if (insideRect(rect, getter(i))) {
+                    indices[n++] = i;
+                }
+            }
+            indices.resize(n);
+        });
+    } else {
+        selectSamples(pai, rect, {}, indices);
+    }
+
+    py::array result = indexArray(indices);
+
+    std::lock_guard<std::mutex> lock(lastSelectionMutex);
+    lastSelection.valid = reuse;
+    if (reuse) {
+        lastSelection.key = key;
+        lastSelection.rect = rect;
+        lastSelection.indices.swap(indices);
+    }
+
+    return result;
+}
+
+py::array selectInPolygon(const PlotArrayInfo& pai, const std::vector<ImPlotPoint>& poly) {
+
+    std::vector<int> indices;
+
+    if (pai.count == 0 || poly.size() < 3) {
+        return indexArray(indices);
+    }
+
+    ImPlotRect bounds(INFINITY, -INFINITY, INFINITY, -INFINITY);
+    for (const ImPlotPoint& p : poly) {
+        bounds.X.Min = ImMin(bounds.X.Min, p.x);
+        bounds.X.Max = ImMax(bounds.X.Max, p.x);
+        bounds.Y.Min = ImMin(bounds.Y.Min, p.y);
+        bounds.Y.Max = ImMax(bounds.Y.Max, p.y);
+    }
+
+    selectSamples(pai, bounds, poly, indices);
+
+    return indexArray(indices);
+}
+
+/**
+ * Histograms
+ *
+ * Samples are binned in parallel chunks into per chunk partial counts
+ * with the GIL released. The counts of versioned data are cached, so
+ * unchanged data is not binned again and only the normalization of the
+ * counts runs every frame.
+ */
+
+static const int HIST_MIN_CHUNK = 65536;
+static const size_t HIST_CACHE_SIZE = 64;
+
+struct HistKey {
+    FitKey data;
+    int xBins;
+    int yBins;
+    ImPlotRect range;
+
+    bool operator==(const HistKey& o) const {
+        return data == o.data && xBins == o.xBins && yBins == o.yBins
+            && range.X.Min == o.range.X.Min && range.X.Max == o.range.X.Max
+            && range.Y.Min == o.range.Y.Min && range.Y.Max == o.range.Y.Max;
+    }
+};
+
+struct HistKeyHash {
+    size_t operator()(const HistKey& k) const {
+        return FitKeyHash()(k.data) ^ ((size_t)k.xBins * 31 + (size_t)k.yBins);
+    }
+};
+
+struct Histogram {
+    int xBins = 0;
+    int yBins = 0;
+    ImPlotRect range;
+    // yBins rows of xBins counts, the row of the highest y bin first
+    std::vector<double> counts;
+    // float copy of the counts and their maximum, uploaded by 2-D histograms
+    std::vector<float> texels;
+    double peak = 0.0;
+    int64_t counted = 0;
+    // samples below the x range (1-D only)
+    int64_t below = 0;
+    // changes whenever the counts change
+    int64_t generation = 0;
+};
+
+static std::unordered_map<HistKey, Histogram, HistKeyHash> histCache;
+static Histogram histScratch;
+static int64_t histGeneration = 0;
+
+struct SampleStats {
+    double min = INFINITY;
+    double max = -INFINITY;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    int64_t n = 0;
+
+    void add(double v) {
+        if (ImNanOrInf(v)) {
+            return;
+        }
+        min = ImMin(min, v);
+        max = ImMax(max, v);
+        sum += v;
+        sumSq += v * v;
+        n += 1;
+    }
+    void merge(const SampleStats& o) {
+        min = ImMin(min, o.min);
+        max = ImMax(max, o.max);
+        sum += o.sum;
+        sumSq += o.sumSq;
+        n += o.n;
+    }
+    double stdDev() const {
+        if (n < 2) {
+            return 0.0;
+        }
+        return std::sqrt(ImMax(0.0, (sumSq - sum * sum / n) / (n - 1)));
+    }
+};
+
+static int histChunks(int count, size_t bins) {
+    // partial counts should not outweigh the samples of a chunk
+    const int64_t minChunk = ImMax((int64_t)HIST_MIN_CHUNK, (int64_t)bins * 4);
+    return (int)ImClamp((int64_t)count / minChunk, (int64_t)1, (int64_t)parallel::threadCount());
+}
+
+template <typename _Indexer>
+SampleStats sampleStats(const _Indexer& values, int count) {
+
+    const int chunks = histChunks(count, 0);
+    std::vector<SampleStats> partial(chunks);
+
+    parallel::run(chunks, [&](int c) {
+        const int begin = (int)((int64_t)count * c / chunks);
+        const int end = (int)((int64_t)count * (c + 1) / chunks);
+        for (int i = begin; i < end; ++i) {
+            partial[c].add(values(i));
+        }
+    });
+
+    for (int c = 1; c < chunks; ++c) {
+        partial[0].merge(partial[c]);
+    }
+
+    return partial[0];
+}
+
+// same rules as ImPlot's CalculateBins, but on the statistics of the finite samples
+static int binCount(int bins, const SampleStats& stats, double rangeSize) {
+
+    const double n = (double)ImMax(stats.n, (int64_t)1);
+
+    switch (bins) {
+        case ImPlotBin_Sqrt: bins = (int)std::ceil(std::sqrt(n)); break;
+        case ImPlotBin_Sturges: bins = (int)std::ceil(1.0 + std::log2(n)); break;
+        case ImPlotBin_Rice: bins = (int)std::ceil(2.0 * std::cbrt(n)); break;
+        case ImPlotBin_Scott: {
+            double width = 3.49 * stats.stdDev() / std::cbrt(n);
+            bins = width > 0.0 ? (int)std::round(rangeSize / width) : 1;
+            break;
+        }
+    }
+
+    return ImClamp(bins, 1, 1 << 20);
+}
+
+IMPLOT_INLINE int binIndex(double v, double min, double width, int bins) {
+    if (!(width > 0.0)) {
+        return 0;
+    }
+    double b = (v - min) / width;
+    return b <= 0.0 ? 0 : b >= bins - 1 ? bins - 1 : (int)b;
+}
+
+template <typename _Indexer>
+void binSamples(const _Indexer& values, int count, Histogram& h) {
+
+    const int bins = h.xBins;
+    const double min = h.range.X.Min;
+    const double max = h.range.X.Max;
+    const double width = h.range.X.Size() / bins;
+
+    const int chunks = histChunks(count, bins);
+    std::vector<std::vector<int64_t>> partial(chunks, std::vector<int64_t>(bins + 2, 0));
+
+    parallel::run(chunks, [&](int c) {
+        const int begin = (int)((int64_t)count * c / chunks);
+        const int end = (int)((int64_t)count * (c + 1) / chunks);
+        int64_t* counts = partial[c].data();
+        int64_t& below = counts[bins];
+        int64_t& counted = counts[bins + 1];
+        for (int i = begin; i < end; ++i) {
+            double v = values(i);
+            if (v >= min && v <= max) {
+                counts[binIndex(v, min, width, bins)] += 1;
+                counted += 1;
+            } else if (v < min) {
+                below += 1;
+            }
+        }
+    });
+
+    h.counts.assign(bins, 0.0);
+    h.below = 0;
+    h.counted = 0;
+    for (int c = 0; c < chunks; ++c) {
+        for (int b = 0; b < bins; ++b) {
+            h.counts[b] += (double)partial[c][b];
+        }
+        h.below += partial[c][bins];
+        h.counted += partial[c][bins + 1];
+    }
+}
+
+template <typename _Getter>
+void binSamples2D(const _Getter& getter, Histogram& h) {
+
+    const int count = getter.Count;
+    const int xBins = h.xBins;
+    const int yBins = h.yBins;
+    const ImPlotRect range = h.range;
+    const double xWidth = range.X.Size() / xBins;
+    const double yWidth = range.Y.Size() / yBins;
+    const size_t bins = (size_t)xBins * yBins;
+
+    const int chunks = histChunks(count, bins);
+    std::vector<std::vector<int64_t>> partial(chunks, std::vector<int64_t>(bins + 1, 0));
+
+    parallel::run(chunks, [&](int c) {
+        const int begin = (int)((int64_t)count * c / chunks);
+        const int end = (int)((int64_t)count * (c + 1) / chunks);
+        int64_t* counts = partial[c].data();
+        int64_t& counted = counts[bins];
+        for (int i = begin; i < end; ++i) {
+            ImPlotPoint p = getter(i);
+            if (range.Contains(p)) {
+                int col = binIndex(p.x, range.X.Min, xWidth, xBins);
+                int row = yBins - 1 - binIndex(p.y, range.Y.Min, yWidth, yBins);
+                counts[(size_t)row * xBins + col] += 1;
+                counted += 1;
+            }
+        }
+    });
+
+    h.counts.assign(bins, 0.0);
+    h.below = 0;
+    h.counted = 0;
+    for (int c = 0; c < chunks; ++c) {
+        for (size_t b = 0; b < bins; ++b) {
+            h.counts[b] += (double)partial[c][b];
+        }
+        h.counted += partial[c][bins];
+    }
+}
+
+/**
+ * Returns the cached histogram of key or a fresh one to be filled in
+ * (the scratch histogram for unversioned data).
+ */
+static Histogram& histogramSlot(const HistKey& key, bool& cached) {
+
+    cached = false;
+
+    if (key.data.version < 0) {
+        return histScratch;
+    }
+
+    auto it = histCache.find(key);
+    if (it != histCache.end()) {
+        cached = true;
+        return it->second;
+    }
+
+    if (histCache.size() >= HIST_CACHE_SIZE) {
+        histCache.clear();
+    }
+
+    return histCache[key];
+}
+
+static const Histogram& histogram1D(const PlotArray& values, size_t count, int bins, ImPlotRange range, int64_t version) {
+
+    PlotArrayInfo pai;
+    pai.y = values;
+    pai.count = count;
+    pai.linearX = true;
+
+    const HistKey key = {fitKey(pai, version), bins, 1, ImPlotRect(range.Min, range.Max, 0.0, 0.0)};
+
+    bool cached = false;
+    Histogram& h = histogramSlot(key, cached);
+    if (cached) {
+        return h;
+    }
+
+    dispatchIndexer(values, [&](const auto& indexer) {
+        py::gil_scoped_release release;
+
+        const bool autoRange = range.Min == 0.0 && range.Max == 0.0;
+        if (autoRange || bins == ImPlotBin_Scott) {
+            SampleStats stats = sampleStats(indexer, (int)count);
+            if (autoRange) {
+                range = stats.n > 0 ? ImPlotRange(stats.min, stats.max) : ImPlotRange(0.0, 1.0);
+            }
+            bins = binCount(bins, stats, range.Size());
+        } else {
+            SampleStats stats;
+            stats.n = (int64_t)count;
+            bins = binCount(bins, stats, range.Size());
+        }
+
+        h.xBins = bins;
+        h.yBins = 1;
+        h.range = ImPlotRect(range.Min, range.Max, 0.0, 0.0);
+        binSamples(indexer, (int)count, h);
+    });
+
+    h.generation = ++histGeneration;
+
+    return h;
+}
+
+double plotHistogram(
+        const char* label,
+        const PlotArray& values,
+        size_t count,
+        int bins,
+        double barScale,
+        ImPlotRange range,
+        ImPlotHistogramFlags flags,
+        int64_t version) {
+
+    if (count == 0 || bins == 0) {
+        return 0.0;
+    }
+
+    const Histogram& h = histogram1D(values, count, bins, range, version);
+
+    const bool cumulative = ImHasFlag(flags, ImPlotHistogramFlags_Cumulative);
+    const bool density = ImHasFlag(flags, ImPlotHistogramFlags_Density);
+    const bool outliers = !ImHasFlag(flags, ImPlotHistogramFlags_NoOutliers);
+    const double width = h.range.X.Size() / h.xBins;
+
+    // same normalization as ImPlot::PlotHistogram
+    static std::vector<double> centers;
+    static std::vector<double> heights;
+
+    centers.resize(h.xBins);
+    heights.assign(h.counts.begin(), h.counts.end());
+
+    for (int b = 0; b < h.xBins; ++b) {
+        centers[b] = h.range.X.Min + b * width + width * 0.5;
+    }
+
+    double maxCount = heights.empty() ? 0.0 : *std::max_element(heights.begin(), heights.end());
+
+    if (cumulative) {
+        if (outliers) {
+            heights[0] += (double)h.below;
+        }
+        for (int b = 1; b < h.xBins; ++b) {
+            heights[b] += heights[b - 1];
+        }
+        maxCount = heights.back();
+    }
+    if (density) {
+        const double total = (double)(outliers ? count : h.counted);
+        const double scale = total > 0.0 ? 1.0 / (cumulative ? total : total * width) : 0.0;
+        for (double& v : heights) {
+            v *= scale;
+        }
+        maxCount *= scale;
+    }
+
+    if (ImHasFlag(flags, ImPlotHistogramFlags_Horizontal)) {
+        PlotBars(label, heights.data(), centers.data(), h.xBins, barScale * width, ImPlotBarsFlags_Horizontal);
+    } else {
+        PlotBars(label, centers.data(), heights.data(), h.xBins, barScale * width);
+    }
+
+    return maxCount;
+}
+
+double plotHistogram2D(
+        const char* label,
+        const PlotArrayInfo& pai,
+        int xBins,
+        int yBins,
+        ImPlotRect range,
+        ImPlotHistogramFlags flags,
+        int64_t version) {
+
+    if (pai.count == 0 || xBins == 0 || yBins == 0) {
+        return 0.0;
+    }
+
+    const HistKey key = {fitKey(pai, version), xBins, yBins, range};
+
+    bool cached = false;
+    Histogram& h = histogramSlot(key, cached);
+
+    if (!cached) {
+        dispatchGetter(pai, [&](const auto& getter) {
+            py::gil_scoped_release release;
+
+            const bool autoX = range.X.Min == 0.0 && range.X.Max == 0.0;
+            const bool autoY = range.Y.Min == 0.0 && range.Y.Max == 0.0;
+
+            SampleStats xStats;
+            SampleStats yStats;
+            xStats.n = yStats.n = getter.Count;
+
+            if (autoX || xBins == ImPlotBin_Scott) {
+                xStats = sampleStats([&](int i) { return getter(i).x; }, getter.Count);
+            }
+            if (autoY || yBins == ImPlotBin_Scott) {
+                yStats = sampleStats([&](int i) { return getter(i).y; }, getter.Count);
+            }
+            if (autoX) {
+                range.X = xStats.n > 0 ? ImPlotRange(xStats.min, xStats.max) : ImPlotRange(0.0, 1.0);
+            }
+            if (autoY) {
+                range.Y = yStats.n > 0 ? ImPlotRange(yStats.min, yStats.max) : ImPlotRange(0.0, 1.0);
+            }
+
+            h.xBins = binCount(xBins, xStats, range.X.Size());
+            h.yBins = binCount(yBins, yStats, range.Y.Size());
+            h.range = range;
+
+            // keep the grid of bins within a sensible texture size
+            h.xBins = ImMin(h.xBins, 4096);
+            h.yBins = ImMin(h.yBins, 4096);
+
+            binSamples2D(getter, h);
+        });
+
+        h.texels.assign(h.counts.begin(), h.counts.end());
+        h.peak = h.counts.empty() ? 0.0 : *std::max_element(h.counts.begin(), h.counts.end());
+        h.generation = ++histGeneration;
+    }
+
+    double maxCount = h.peak;
+
+    // density only scales the counts, which is left to the color scale
+    if (ImHasFlag(flags, ImPlotHistogramFlags_Density)) {
+        const bool outliers = !ImHasFlag(flags, ImPlotHistogramFlags_NoOutliers);
+        const double total = (double)(outliers ? pai.count : (size_t)h.counted);
+        const double area = (h.range.X.Size() / h.xBins) * (h.range.Y.Size() / h.yBins);
+        maxCount *= total > 0.0 && area > 0.0 ? 1.0 / (total * area) : 0.0;
+    }
+
+    // unchanged counts keep their texture and are neither copied nor uploaded
+    plotValueImage(
+            label,
+            h.texels.data(),
+            h.xBins,
+            h.yBins,
+            version < 0 ? -1 : h.generation,
+            0.0,
+            h.peak > 0.0 ? h.peak : 1.0,
+            IMPLOT_AUTO,
+            h.range.Min(),
+            h.range.Max(),
+            ImPlotItemFlags_None);
+
+    return maxCount;
+}
+
+/**
+ * Density
+ *
+ * Scatter plots of millions of points are splatted into a count per
+ * pixel of the plot area in parallel chunks instead of drawing one
+ * marker per point. The log of the counts is mapped through a colormap
+ * and drawn as a single texture, so the draw cost depends on the size
+ * of the plot rather than on the number of points.
+ */
+
+static const int DENSITY_MIN_CHUNK = 65536;
+static const size_t DENSITY_AUTO_POINTS = 5000000;
+
+static std::vector<uint32_t> densityCounts;
+static std::vector<float> densityValues;
+static std::vector<float> densityRowMax;
+
+bool shouldSplat(size_t count) {
+
+    return count > DENSITY_AUTO_POINTS;
+}
+
+template <typename _Getter, typename _Fitter>
+void PlotDensityEx(const char* label_id, ImGuiID textureId, const _Getter& getter, const _Fitter& fitter, ImPlotColormap cmap, ImPlotItemFlags flags) {
+    if (BeginItemEx(label_id, fitter, flags, ImPlotCol_MarkerFill)) {
+        if (cmap == IMPLOT_AUTO) {
+            cmap = GImPlot->Style.Colormap;
+        }
+        GetCurrentItem()->Color = SampleColormapU32(0.75f, cmap);
+
+        const ImRect rect = GetCurrentPlot()->PlotRect;
+        const int width = (int)rect.GetWidth();
+        const int height = (int)rect.GetHeight();
+        const int count = getter.Count;
+
+        if (width <= 0 || height <= 0 || count <= 0) {
+            EndItem();
+            return;
+        }
+
+        const size_t pixels = (size_t)width * height;
+
+        // a chunk should splat more points than it has pixels to merge
+        const int64_t minChunk = ImMax((int64_t)DENSITY_MIN_CHUNK, (int64_t)pixels / 8);
+        const int chunks = (int)ImClamp((int64_t)count / minChunk, (int64_t)1, (int64_t)parallel::threadCount());
+
+        densityCounts.resize((size_t)chunks * pixels);
+        densityValues.resize(pixels);
+        densityRowMax.resize(height);
+
+        {
+            py::gil_scoped_release release;
+
+            Transformer2 transformer;
+            const float w = (float)width;
+            const float h = (float)height;
+
+            parallel::run(chunks, [&](int c) {
+                uint32_t* counts = densityCounts.data() + (size_t)c * pixels;
+                std::fill(counts, counts + pixels, 0u);
+
+                const int begin = (int)((int64_t)count * c / chunks);
+                const int end = (int)((int64_t)count * (c + 1) / chunks);
+                for (int i = begin; i < end; ++i) {
+                    ImPlotPoint p = getter(i);
+                    if (ImNanOrInf(p.x) || ImNanOrInf(p.y)) {
+                        continue;
+                    }
+                    ImVec2 px = transformer(p);
+                    float col = px.x - rect.Min.x;
+                    float row = px.y - rect.Min.y;
+                    if (col >= 0.0f && col < w && row >= 0.0f && row < h) {
+                        counts[(size_t)row * width + (size_t)col] += 1;
+                    }
+                }
+            });
+
+            // merge and tone map by rows, empty pixels stay transparent
+            parallel::run(height, [&](int row) {
+                float rowMax = 0.0f;
+                for (int col = 0; col < width; ++col) {
+                    const size_t i = (size_t)row * width + col;
+                    uint32_t n = 0;
+                    for (int c = 0; c < chunks; ++c) {
+                        n += densityCounts[(size_t)c * pixels + i];
+                    }
+                    float v = n > 0 ? std::log1p((float)n) : NAN;
+                    densityValues[i] = v;
+                    rowMax = n > 0 ? ImMax(rowMax, v) : rowMax;
+                }
+                densityRowMax[row] = rowMax;
+            });
+        }
+
+        const float vmax = *std::max_element(densityRowMax.begin(), densityRowMax.end());
+
+        drawValueImage(textureId, densityValues.data(), width, height, 0.0, vmax > 0.0f ? vmax : 1.0, cmap, rect.Min, ImVec2(rect.Min.x + width, rect.Min.y + height));
+
+        EndItem();
+    }
+}
+
+void plotDensity(
+        const char* label,
+        PlotArrayInfo& pai,
+        ImPlotColormap cmap,
+        ImPlotItemFlags flags) {
+
+    // separate from the texture of a heatmap with the same label
+    const ImGuiID textureId = ImHashStr("##density", 0, ImGui::GetID(label));
+
+    dispatchGetter(pai, [&](const auto& getter) {
+        using G = std::decay_t<decltype(getter)>;
+        if (pai.hasBounds) {
+            PlotDensityEx(label, textureId, getter, FitterBounds<G>(getter, pai.bounds), cmap, flags);
+        } else {
+            PlotDensityEx(label, textureId, getter, Fitter1<G>(getter), cmap, flags);
+        }
+    });
 }
 
 }
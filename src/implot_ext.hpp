@@ -1,12 +1,161 @@
+#include <cmath>
+#include <optional>
+
 #include "binding_helpers.hpp"
+#include "plot_series.hpp"
 
 namespace ImPlot {
 
-void customPlot(
+void cacheBounds(PlotArrayInfo& pai, int64_t version);
+
+// scans the bounds (and sortedness) of the samples once, without caching
+void computeBounds(PlotArrayInfo& pai);
+
+void plotLine(
         const char* label,
         PlotArrayInfo& pai,
+        ImPlotLineFlags flags = ImPlotLineFlags_None,
+        bool decimate = true);
+
+// with dedup, markers are skipped if their pixel already holds a marker
+void plotScatter(
+        const char* label,
+        PlotArrayInfo& pai,
+        ImPlotScatterFlags flags = ImPlotScatterFlags_None,
+        bool dedup = false);
+
+void plotMany(
+        const std::vector<std::string>& labels,
+        PlotArrayInfo& pai,
+        size_t rows,
+        ptrdiff_t rowStride,
+        const std::vector<ImVec4>& colors,
+        bool line,
+        float lineWeight,
+        ImPlotMarker marker,
+        float markerSize,
+        float markerWeight,
+        ImPlotLineFlags flags = ImPlotLineFlags_None,
+        bool decimate = true);
+
+void plotShaded(
+        const char* label,
+        PlotArrayInfo& pai,
+        const double* lower,
+        const double* upper,
+        size_t count,
+        ImPlotShadedFlags flags = ImPlotShadedFlags_None,
+        bool decimate = true);
+
+void plotBars(
+        const char* label,
+        PlotArrayInfo& pai,
+        double barSize,
+        ImPlotBarsFlags flags = ImPlotBarsFlags_None);
+
+void plotInfLines(
+        const char* label,
+        PlotArray& values,
+        size_t count,
+        ImPlotInfLinesFlags flags = ImPlotInfLinesFlags_None);
+
+void plotStream(
+        const char* label,
+        StreamSeries& stream,
+        bool line = true,
+        ImPlotLineFlags flags = ImPlotLineFlags_None,
+        bool decimate = true);
+
+void buildLod(LodSeries& lod);
+
+void plotLod(
+        const char* label,
+        LodSeries& lod,
+        ImPlotLineFlags flags = ImPlotLineFlags_None);
+
+const ImU32* packColors(
         py::handle color,
+        size_t count,
+        py::array& holder);
+
+const ImU32* mapColorValues(
+        py::handle values,
+        size_t count,
+        ImPlotColormap cmap = IMPLOT_AUTO,
+        std::optional<double> vmin = std::nullopt,
+        std::optional<double> vmax = std::nullopt);
+
+const ImU32* mapColorIndices(
+        py::handle indices,
+        size_t count,
+        py::handle palette,
+        ImPlotColormap cmap = IMPLOT_AUTO);
+
+void customPlot(
+        const char* label,
+        PlotArrayInfo& pai,
+        const ImU32* colors,
         bool noLine = false,
-        ImPlotFlags flags = ImPlotFlags_None);
+        ImPlotFlags flags = ImPlotFlags_None,
+        bool decimate = true,
+        bool dedup = false);
+
+// index of the sample closest to the mouse within pixelRadius or -1,
+// versioned data (version >= 0) is searched through a cached grid
+int64_t nearestPoint(
+        const PlotArrayInfo& pai,
+        float pixelRadius,
+        int64_t version = -1,
+        ImAxis xAxis = IMPLOT_AUTO,
+        ImAxis yAxis = IMPLOT_AUTO);
+
+// indices of the samples inside rect, incremental selections of
+// versioned data reuse the previous result while the rect shrinks
+py::array selectInRect(
+        const PlotArrayInfo& pai,
+        ImPlotRect rect,
+        int64_t version = -1,
+        bool incremental = false);
+
+// indices of the samples inside the polygon (even-odd rule)
+py::array selectInPolygon(
+        const PlotArrayInfo& pai,
+        const std::vector<ImPlotPoint>& poly);
+
+// histogram of count values plotted as bars, returns the largest bar
+// height, the counts of versioned data are cached until it changes
+double plotHistogram(
+        const char* label,
+        const PlotArray& values,
+        size_t count,
+        int bins = ImPlotBin_Sturges,
+        double barScale = 1.0,
+        ImPlotRange range = ImPlotRange(),
+        ImPlotHistogramFlags flags = ImPlotHistogramFlags_None,
+        int64_t version = -1);
+
+// 2-D histogram of (x, y) plotted as a heatmap, returns the largest count
+double plotHistogram2D(
+        const char* label,
+        const PlotArrayInfo& pai,
+        int xBins = ImPlotBin_Sturges,
+        int yBins = ImPlotBin_Sturges,
+        ImPlotRect range = ImPlotRect(),
+        ImPlotHistogramFlags flags = ImPlotHistogramFlags_None,
+        int64_t version = -1);
+
+// whether a scatter plot of count points is drawn as a density image by default
+bool shouldSplat(size_t count);
+
+// points splatted into a count per pixel of the plot area, drawn as
+// log(1 + count) mapped through cmap
+void plotDensity(
+        const char* label,
+        PlotArrayInfo& pai,
+        ImPlotColormap cmap = IMPLOT_AUTO,
+        ImPlotItemFlags flags = ImPlotItemFlags_None);
+
+// draws large numbers of markers as quads textured with pre-rasterized sprites
+void setMarkerSprites(bool enabled);
 
 }
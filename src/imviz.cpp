@@ -18,6 +18,7 @@
 #include "input.hpp"
 #include "source_sans_pro.hpp"
 #include "fa_solid_900.hpp"
+#include "marker_sprites.hpp"
 
 #include "imgui_internal.h"
 #include "implot_internal.h"
@@ -242,6 +243,9 @@ void ImViz::reloadFonts() {
                 &iconsConfig,
                 iconsRanges);
 
+        ImPlot::addMarkerSprites(io.Fonts);
+        ImPlot::bakeMarkerSprites(io.Fonts);
+
         ImGui_ImplOpenGL3_CreateFontsTexture();
     }
 }
@@ -0,0 +1,233 @@
+#include "marker_sprites.hpp"
+
+#include <cmath>
+
+#include "imgui_internal.h"
+
+namespace ImPlot {
+
+// side of a sprite in texels and samples per texel along each axis
+static const int SPRITE_SIZE = 32;
+static const int SPRITE_SAMPLES = 4;
+
+// outlines are baked with these stroke widths relative to the marker size
+static const int STROKE_LEVELS = 4;
+static const float STROKE_RATIOS[STROKE_LEVELS] = {0.125f, 0.25f, 0.5f, 1.0f};
+
+static const float S2 = 0.70710678f;
+static const float S3 = 0.86602540f;
+
+/**
+ * Marker shapes, the same as those of ImPlot's marker renderers
+ * (y points down).
+ */
+
+struct Shape {
+    // corners of a convex polygon or end points of line segments
+    ImVec2 points[12];
+    int count;
+    // circles are rasterized exactly instead of as polygons
+    bool circle;
+};
+
+static const Shape FILL_SHAPES[] = {
+    {{}, 0, true},
+    {{{S2, S2}, {S2, -S2}, {-S2, -S2}, {-S2, S2}}, 4, false},
+    {{{1, 0}, {0, -1}, {-1, 0}, {0, 1}}, 4, false},
+    {{{S3, 0.5f}, {0, -1}, {-S3, 0.5f}}, 3, false},
+    {{{S3, -0.5f}, {0, 1}, {-S3, -0.5f}}, 3, false},
+    {{{-1, 0}, {0.5f, S3}, {0.5f, -S3}}, 3, false},
+    {{{1, 0}, {-0.5f, S3}, {-0.5f, -S3}}, 3, false}
+};
+
+static const int FILL_SHAPE_COUNT = sizeof(FILL_SHAPES) / sizeof(Shape);
+
+static const Shape LINE_SHAPES[] = {
+    {{}, 0, true},
+    {{{S2, S2}, {S2, -S2}, {S2, -S2}, {-S2, -S2}, {-S2, -S2}, {-S2, S2}, {-S2, S2}, {S2, S2}}, 8, false},
+    {{{1, 0}, {0, -1}, {0, -1}, {-1, 0}, {-1, 0}, {0, 1}, {0, 1}, {1, 0}}, 8, false},
+    {{{S3, 0.5f}, {0, -1}, {0, -1}, {-S3, 0.5f}, {-S3, 0.5f}, {S3, 0.5f}}, 6, false},
+    {{{S3, -0.5f}, {0, 1}, {0, 1}, {-S3, -0.5f}, {-S3, -0.5f}, {S3, -0.5f}}, 6, false},
+    {{{-1, 0}, {0.5f, S3}, {0.5f, S3}, {0.5f, -S3}, {0.5f, -S3}, {-1, 0}}, 6, false},
+    {{{1, 0}, {-0.5f, S3}, {-0.5f, S3}, {-0.5f, -S3}, {-0.5f, -S3}, {1, 0}}, 6, false},
+    {{{-S2, S2}, {S2, -S2}, {S2, S2}, {-S2, -S2}}, 4, false},
+    {{{-1, 0}, {1, 0}, {0, -1}, {0, 1}}, 4, false},
+    {{{S3, 0.5f}, {-S3, -0.5f}, {S3, -0.5f}, {-S3, 0.5f}, {0, 1}, {0, -1}}, 6, false}
+};
+
+static const int LINE_SHAPE_COUNT = sizeof(LINE_SHAPES) / sizeof(Shape);
+
+struct SpriteAtlas {
+    ImFontAtlas* atlas = nullptr;
+    bool baked = false;
+    int fillRects[FILL_SHAPE_COUNT];
+    int lineRects[LINE_SHAPE_COUNT][STROKE_LEVELS];
+    MarkerSprite fill[FILL_SHAPE_COUNT];
+    MarkerSprite line[LINE_SHAPE_COUNT][STROKE_LEVELS];
+};
+
+static SpriteAtlas sprites;
+
+static float cross(const ImVec2& a, const ImVec2& b, const ImVec2& p) {
+    return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+static bool insideFill(const Shape& shape, const ImVec2& p) {
+
+    if (shape.circle) {
+        return p.x * p.x + p.y * p.y <= 1.0f;
+    }
+
+    // convex, so p has to be on the same side of every edge
+    bool pos = false;
+    bool neg = false;
+    for (int i = 0; i < shape.count; ++i) {
+        float c = cross(shape.points[i], shape.points[(i + 1) % shape.count], p);
+        pos = pos || c > 0.0f;
+        neg = neg || c < 0.0f;
+    }
+
+    return !(pos && neg);
+}
+
+static float segmentDistance(const ImVec2& a, const ImVec2& b, const ImVec2& p) {
+
+    ImVec2 ab(b.x - a.x, b.y - a.y);
+    ImVec2 ap(p.x - a.x, p.y - a.y);
+    float t = ImClamp((ap.x * ab.x + ap.y * ab.y) / (ab.x * ab.x + ab.y * ab.y), 0.0f, 1.0f);
+    float dx = ap.x - t * ab.x;
+    float dy = ap.y - t * ab.y;
+
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+static bool insideLine(const Shape& shape, const ImVec2& p, float halfStroke) {
+
+    if (shape.circle) {
+        return std::fabs(std::sqrt(p.x * p.x + p.y * p.y) - 1.0f) <= halfStroke;
+    }
+
+    for (int i = 0; i < shape.count; i += 2) {
+        if (segmentDistance(shape.points[i], shape.points[i + 1], p) <= halfStroke) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// keeps two texels of margin for the antialiased edge around the shape
+static float spriteExtent(float halfStroke) {
+    return (1.0f + halfStroke) * SPRITE_SIZE / (SPRITE_SIZE - 4);
+}
+
+static void bakeSprite(
+        ImFontAtlas* atlas,
+        unsigned int* pixels,
+        int texWidth,
+        int rectIndex,
+        const Shape& shape,
+        bool fill,
+        float halfStroke,
+        MarkerSprite& sprite) {
+
+    const ImFontAtlasCustomRect* rect = atlas->GetCustomRectByIndex(rectIndex);
+
+    sprite.extent = spriteExtent(halfStroke);
+    atlas->CalcCustomRectUV(rect, &sprite.uv0, &sprite.uv1);
+
+    const float texel = 2.0f * sprite.extent / SPRITE_SIZE;
+    const int samples = SPRITE_SAMPLES * SPRITE_SAMPLES;
+
+    for (int y = 0; y < SPRITE_SIZE; ++y) {
+        for (int x = 0; x < SPRITE_SIZE; ++x) {
+            int covered = 0;
+            for (int sy = 0; sy < SPRITE_SAMPLES; ++sy) {
+                for (int sx = 0; sx < SPRITE_SAMPLES; ++sx) {
+                    ImVec2 p(
+                        (x + (sx + 0.5f) / SPRITE_SAMPLES) * texel - sprite.extent,
+                        (y + (sy + 0.5f) / SPRITE_SAMPLES) * texel - sprite.extent);
+                    if (fill ? insideFill(shape, p) : insideLine(shape, p, halfStroke)) {
+                        covered += 1;
+                    }
+                }
+            }
+            const unsigned int alpha = (unsigned int)(covered * 255 / samples);
+            pixels[(rect->Y + y) * texWidth + rect->X + x] = IM_COL32(255, 255, 255, alpha);
+        }
+    }
+}
+
+void addMarkerSprites(ImFontAtlas* atlas) {
+
+    sprites.atlas = atlas;
+    sprites.baked = false;
+
+    for (int m = 0; m < FILL_SHAPE_COUNT; ++m) {
+        sprites.fillRects[m] = atlas->AddCustomRectRegular(SPRITE_SIZE, SPRITE_SIZE);
+    }
+    for (int m = 0; m < LINE_SHAPE_COUNT; ++m) {
+        for (int l = 0; l < STROKE_LEVELS; ++l) {
+            sprites.lineRects[m][l] = atlas->AddCustomRectRegular(SPRITE_SIZE, SPRITE_SIZE);
+        }
+    }
+}
+
+void bakeMarkerSprites(ImFontAtlas* atlas) {
+
+    if (sprites.atlas != atlas) {
+        return;
+    }
+
+    unsigned char* data = nullptr;
+    int width = 0;
+    int height = 0;
+    atlas->GetTexDataAsRGBA32(&data, &width, &height);
+
+    unsigned int* pixels = (unsigned int*)data;
+
+    for (int m = 0; m < FILL_SHAPE_COUNT; ++m) {
+        bakeSprite(atlas, pixels, width, sprites.fillRects[m], FILL_SHAPES[m], true, 0.0f, sprites.fill[m]);
+    }
+    for (int m = 0; m < LINE_SHAPE_COUNT; ++m) {
+        for (int l = 0; l < STROKE_LEVELS; ++l) {
+            bakeSprite(atlas, pixels, width, sprites.lineRects[m][l], LINE_SHAPES[m], false, 0.5f * STROKE_RATIOS[l], sprites.line[m][l]);
+        }
+    }
+
+    sprites.baked = true;
+}
+
+const MarkerSprite* findMarkerSprite(ImPlotMarker marker, bool fill, float size, float weight) {
+
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+
+    if (!sprites.baked || sprites.atlas != atlas || !atlas->IsBuilt() || marker < 0) {
+        return nullptr;
+    }
+
+    if (fill) {
+        if (marker >= FILL_SHAPE_COUNT) {
+            return nullptr;
+        }
+        const MarkerSprite& sprite = sprites.fill[marker];
+        // larger markers would be blurry
+        return 2.0f * size * sprite.extent <= SPRITE_SIZE ? &sprite : nullptr;
+    }
+
+    if (marker >= LINE_SHAPE_COUNT || size <= 0.0f) {
+        return nullptr;
+    }
+
+    // same stroke width as ImPlot's marker lines, closest baked level within a factor of sqrt(2)
+    const float ratio = ImMax(1.0f, weight) / size;
+    const int level = (int)std::lround(std::log2(ratio / STROKE_RATIOS[0]));
+    if (level < 0 || level >= STROKE_LEVELS) {
+        return nullptr;
+    }
+
+    const MarkerSprite& sprite = sprites.line[marker][level];
+
+    return 2.0f * size * sprite.extent <= SPRITE_SIZE ? &sprite : nullptr;
+}
+}
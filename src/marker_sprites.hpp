@@ -0,0 +1,34 @@
+#pragma once
+
+#include <imgui.h>
+
+#include "implot.h"
+
+/**
+ * Pre-rasterized markers, baked into the font atlas.
+ *
+ * Every marker shape is rasterized once with antialiased edges into a
+ * custom rect of the font atlas, filled shapes once and outlines at a few
+ * stroke widths relative to the marker size. A marker can then be drawn
+ * as one textured quad (4 vertices, 6 indices) within the same draw
+ * command as the rest of the plot.
+ */
+namespace ImPlot {
+
+struct MarkerSprite {
+    ImVec2 uv0;
+    ImVec2 uv1;
+    // half the side of the quad in units of the marker size
+    float extent = 0.0f;
+};
+
+// reserves the rects of the sprites, call before the atlas is built
+void addMarkerSprites(ImFontAtlas* atlas);
+
+// rasterizes the sprites into the built atlas, call before its texture is uploaded
+void bakeMarkerSprites(ImFontAtlas* atlas);
+
+// sprite looking like the given marker or nullptr if there is none
+// (e.g. the atlas has no sprites, or the marker is too large for them)
+const MarkerSprite* findMarkerSprite(ImPlotMarker marker, bool fill, float size, float weight);
+}
@@ -0,0 +1,153 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+struct Pool {
+
+    Pool() {
+
+        int workers = (int)std::thread::hardware_concurrency() - 1;
+
+        for (int i = 0; i < std::max(workers, 0); ++i) {
+            threads.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~Pool() {
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wakeUp.notify_all();
+
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    void work() {
+
+        uint64_t seenGeneration = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [&]() { return stop || generation != seenGeneration; });
+                if (stop) {
+                    return;
+                }
+                seenGeneration = generation;
+            }
+
+            runTasks();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending -= 1;
+            }
+            done.notify_all();
+        }
+    }
+
+    void runTasks() {
+
+        while (true) {
+            int i = next.fetch_add(1);
+            if (i >= count) {
+                return;
+            }
+            try {
+                (*task)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void run(int taskCount, const std::function<void(int)>& f) {
+
+        // only one job at a time
+        std::lock_guard<std::mutex> jobLock(jobMutex);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &f;
+            count = taskCount;
+            next = 0;
+            error = nullptr;
+            pending = (int)threads.size();
+            generation += 1;
+        }
+        wakeUp.notify_all();
+
+        runTasks();
+
+        // every worker takes part in every job, wait until all are through
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&]() { return pending == 0; });
+            task = nullptr;
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<std::thread> threads;
+
+    std::mutex jobMutex;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable done;
+
+    const std::function<void(int)>* task = nullptr;
+    int count = 0;
+    std::atomic<int> next{0};
+    uint64_t generation = 0;
+    int pending = 0;
+    bool stop = false;
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+static Pool& pool() {
+
+    static Pool p;
+    return p;
+}
+
+int threadCount() {
+
+    return (int)pool().threads.size() + 1;
+}
+
+void run(int count, const std::function<void(int)>& task) {
+
+    if (count <= 0) {
+        return;
+    }
+
+    if (count == 1 || pool().threads.empty()) {
+        for (int i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    pool().run(count, task);
+}
+}
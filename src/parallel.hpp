@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * A small pool of persistent worker threads for data parallel work,
+ * e.g. generating the geometry of large series.
+ *
+ * The pool is created on first use. The calling thread takes part in
+ * the work, so run() may also be used if there are no workers at all.
+ */
+namespace parallel {
+
+// number of threads run() distributes tasks to (including the caller)
+int threadCount();
+
+// calls task(i) for every i in [0, count) and returns when all are done,
+// the first exception thrown by a task is rethrown on the calling thread
+void run(int count, const std::function<void(int)>& task);
+}
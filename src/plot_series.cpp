@@ -0,0 +1,301 @@
+#include "plot_series.hpp"
+#include "implot_ext.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+StreamSeries::StreamSeries(size_t capacity, py::dtype dtype, bool wake)
+    : dtype(dtype),
+      capacity(capacity),
+      wake(wake) {
+
+    if (capacity == 0) {
+        throw std::runtime_error("StreamSeries capacity must be positive");
+    }
+
+    double timeScale = 0.0;
+    type = plotDataType(dtype, timeScale);
+
+    if (type == ImGuiDataType_COUNT || timeScale != 0.0) {
+        throw std::runtime_error("Unsupported StreamSeries dtype "
+                + std::string(py::str(dtype)));
+    }
+
+    size_t bytes = capacity * dtype.itemsize();
+    xData.resize(bytes);
+    yData.resize(bytes);
+}
+
+template <typename T>
+void StreamSeries::appendAs(py::handle x, py::handle y) {
+
+    array_like<T> xs = array_like<T>::ensure(x);
+    array_like<T> ys = array_like<T>::ensure(y);
+
+    if (!xs || !ys) {
+        throw py::error_already_set();
+    }
+
+    size_t n = (size_t)std::min(xs.size(), ys.size());
+    const T* xp = xs.data();
+    const T* yp = ys.data();
+
+    py::gil_scoped_release release;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // only the newest samples fit into the buffer
+    if (n > capacity) {
+        xp += n - capacity;
+        yp += n - capacity;
+        n = capacity;
+    }
+
+    T* xBuf = (T*)xData.data();
+    T* yBuf = (T*)yData.data();
+
+    for (size_t i = 0; i < n; ++i) {
+
+        // a full ring drops its oldest sample, and with it the pair
+        // of the oldest and the second oldest sample
+        if (count == capacity) {
+            if (count > 1 && (double)xBuf[(offset + 1) % capacity] < (double)xBuf[offset]) {
+                descents -= 1;
+            }
+            offset = (offset + 1) % capacity;
+            count -= 1;
+        }
+
+        if (count > 0 && (double)xp[i] < lastX) {
+            descents += 1;
+        }
+        lastX = (double)xp[i];
+
+        size_t k = (offset + count) % capacity;
+        xBuf[k] = xp[i];
+        yBuf[k] = yp[i];
+
+        count += 1;
+    }
+
+    xSorted = descents == 0;
+}
+
+void StreamSeries::append(py::handle x, py::handle y) {
+
+    switch (type) {
+        case ImGuiDataType_S8: appendAs<int8_t>(x, y); break;
+        case ImGuiDataType_U8: appendAs<uint8_t>(x, y); break;
+        case ImGuiDataType_S16: appendAs<int16_t>(x, y); break;
+        case ImGuiDataType_U16: appendAs<uint16_t>(x, y); break;
+        case ImGuiDataType_S32: appendAs<int32_t>(x, y); break;
+        case ImGuiDataType_U32: appendAs<uint32_t>(x, y); break;
+        case ImGuiDataType_S64: appendAs<int64_t>(x, y); break;
+        case ImGuiDataType_U64: appendAs<uint64_t>(x, y); break;
+        case ImGuiDataType_Float: appendAs<float>(x, y); break;
+        default: appendAs<double>(x, y); break;
+    }
+}
+
+void StreamSeries::clear() {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    offset = 0;
+    count = 0;
+    xSorted = true;
+    descents = 0;
+    lastX = 0.0;
+}
+
+size_t StreamSeries::size() {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return count;
+}
+
+void StreamSeries::unroll(uint8_t* x, uint8_t* y) const {
+
+    if (count == 0) {
+        return;
+    }
+
+    const size_t itemSize = xData.size() / capacity;
+    const size_t first = std::min(count, capacity - offset);
+
+    std::memcpy(x, xData.data() + offset * itemSize, first * itemSize);
+    std::memcpy(x + first * itemSize, xData.data(), (count - first) * itemSize);
+    std::memcpy(y, yData.data() + offset * itemSize, first * itemSize);
+    std::memcpy(y + first * itemSize, yData.data(), (count - first) * itemSize);
+}
+
+void StreamSeries::snapshot(py::array& x, py::array& y, bool& sorted) {
+
+    // producers hold the lock without the GIL, so waiting here cannot deadlock
+    std::lock_guard<std::mutex> lock(mutex);
+
+    x = py::array(dtype, {(py::ssize_t)count});
+    y = py::array(dtype, {(py::ssize_t)count});
+    unroll((uint8_t*)x.mutable_data(), (uint8_t*)y.mutable_data());
+    sorted = xSorted;
+}
+
+// unique per series, LodSeries and PlotSeries versions are taken from it
+static int64_t seriesGeneration = 0;
+
+LodSeries::LodSeries(py::handle x, py::handle y, double x0, double dx) {
+
+    generation = ++seriesGeneration;
+
+    xArray = toPlotArray(x);
+    yArray = toPlotArray(y);
+
+    pai = interpretPlotArrays(xArray, yArray, x0, dx);
+
+    if (pai.count > (size_t)INT_MAX) {
+        throw std::runtime_error("LodSeries supports at most 2^31 - 1 samples");
+    }
+
+    worker = std::thread([this]() {
+        ImPlot::buildLod(*this);
+    });
+}
+
+LodSeries::~LodSeries() {
+
+    cancel = true;
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+PlotSeries::PlotSeries(
+        py::handle x,
+        py::handle y,
+        const std::string& fmt,
+        const std::string& label,
+        py::handle color,
+        float lineWeight,
+        float markerSize,
+        float markerWeight,
+        ImPlotLineFlags flags,
+        bool decimate,
+        double x0,
+        double dx,
+        bool xSorted,
+        py::handle colorValues,
+        py::handle colorIndex,
+        ImPlotColormap colormap,
+        std::optional<double> vmin,
+        std::optional<double> vmax,
+        py::handle palette)
+    : label(label),
+      lineWeight(lineWeight),
+      markerSize(markerSize),
+      markerWeight(markerWeight),
+      flags(flags),
+      decimate(decimate),
+      colorValues(py::reinterpret_borrow<py::object>(colorValues)),
+      colorIndex(py::reinterpret_borrow<py::object>(colorIndex)),
+      palette(py::reinterpret_borrow<py::object>(palette)),
+      colormap(colormap),
+      vmin(vmin),
+      vmax(vmax) {
+
+    setStyle(fmt, color);
+    setData(x, y, x0, dx, xSorted);
+}
+
+void PlotSeries::setData(py::handle x, py::handle y, double x0, double dx, bool xSorted) {
+
+    xArray = toPlotArray(x);
+    yArray = toPlotArray(y);
+
+    pai = interpretPlotArrays(xArray, yArray, x0, dx);
+    pai.xSorted = pai.xSorted || xSorted;
+    xSortedArg = xSorted;
+
+    ImPlot::computeBounds(pai);
+    generation = ++seriesGeneration;
+
+    mapColors();
+}
+
+void PlotSeries::invalidate() {
+
+    // the sortedness is scanned again along with the bounds
+    pai.xSorted = (pai.linearX && pai.dx > 0.0) || xSortedArg;
+
+    ImPlot::computeBounds(pai);
+    generation = ++seriesGeneration;
+
+    mapColors();
+}
+
+void PlotSeries::setStyle(const std::string& fmt, py::handle color) {
+
+    PlotFormat format = interpretFormat(fmt);
+    line = format.line;
+    marker = format.marker;
+
+    // an explicit color overrides the one of the format string
+    bool isArray = false;
+    this->color = interpretColor(color, &isArray);
+    if (this->color.w < 0.0f) {
+        this->color = format.color;
+    }
+
+    colorArg = isArray ? py::reinterpret_borrow<py::object>(color) : py::object();
+
+    if (pai.count > 0) {
+        mapColors();
+    }
+}
+
+void PlotSeries::mapColors() {
+
+    const ImU32* colors = nullptr;
+    py::array holder;
+
+    if (colorValues && !colorValues.is_none()) {
+        colors = ImPlot::mapColorValues(colorValues, pai.count, colormap, vmin, vmax);
+    } else if (colorIndex && !colorIndex.is_none()) {
+        colors = ImPlot::mapColorIndices(colorIndex, pai.count, palette, colormap);
+    } else if (colorArg) {
+        colors = ImPlot::packColors(colorArg, pai.count, holder);
+    }
+
+    // the mapped colors live in buffers shared by all plots
+    if (colors != nullptr) {
+        pointColors = std::make_shared<const std::vector<ImU32>>(colors, colors + pai.count);
+    } else {
+        pointColors.reset();
+    }
+}
+
+void PlotSeries::draw() {
+
+    // the render releases the GIL, in which time another thread may call
+    // setData() and free the arrays, so the frame keeps its own references
+    py::array xHeld = xArray;
+    py::array yHeld = yArray;
+    PlotArrayInfo data = pai;
+    std::shared_ptr<const std::vector<ImU32>> colors = pointColors;
+    const std::string name = label;
+
+    ImPlot::SetNextLineStyle(color, lineWeight);
+    ImPlot::SetNextMarkerStyle(marker, markerSize, color, markerWeight, color);
+
+    if (colors) {
+        ImPlot::customPlot(name.c_str(), data, colors->data(), !line, flags, decimate);
+    } else if (line) {
+        ImPlot::plotLine(name.c_str(), data, flags, decimate);
+    } else if (ImPlot::shouldSplat(data.count) && color.w < 0.0f) {
+        ImPlot::plotDensity(name.c_str(), data, IMPLOT_AUTO, flags);
+    } else {
+        ImPlot::plotScatter(name.c_str(), data, flags);
+    }
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "binding_helpers.hpp"
+
+/**
+ * Fixed capacity ring buffer of (x, y) samples in a native dtype.
+ *
+ * Samples can be appended from any thread, the GIL is released while
+ * they are copied. Plotting copies the ring in its native dtype and
+ * renders the copy, so a stream does not have to be converted every
+ * frame and producers do not wait for the render.
+ */
+struct StreamSeries {
+
+    StreamSeries(size_t capacity, py::dtype dtype, bool wake);
+
+    void append(py::handle x, py::handle y);
+    void clear();
+    size_t size();
+
+    // copies the samples in order, the oldest first, to x and y with room
+    // for count samples, to be called with the mutex held
+    void unroll(uint8_t* x, uint8_t* y) const;
+
+    // copies of the current samples as arrays, for queries like nearest_point()
+    void snapshot(py::array& x, py::array& y, bool& sorted);
+
+    // guards the buffers and the ring state below
+    std::mutex mutex;
+
+    py::dtype dtype;
+    ImGuiDataType type = ImGuiDataType_Double;
+    size_t capacity = 0;
+
+    std::vector<uint8_t> xData;
+    std::vector<uint8_t> yData;
+
+    // unrolled copy of the ring, only used by plotting
+    std::vector<uint8_t> xSnapshot;
+    std::vector<uint8_t> ySnapshot;
+
+    // index of the oldest sample and number of valid samples
+    size_t offset = 0;
+    size_t count = 0;
+
+    // x of the samples in the buffer is in ascending order, tracked by
+    // the number of neighbouring samples in descending order, so that
+    // it becomes true again once unsorted samples are overwritten
+    bool xSorted = true;
+    size_t descents = 0;
+    double lastX = 0.0;
+
+    // wake up a powersaving wait() whenever samples are appended
+    bool wake = false;
+
+private:
+
+    template <typename T>
+    void appendAs(py::handle x, py::handle y);
+};
+
+/**
+ * Static series with a min/max level of detail pyramid.
+ *
+ * The pyramid is built once in a background thread. Until it is ready
+ * the series is plotted like a regular line. Afterwards only the level
+ * matching the visible x range and the plot width is read, so the cost
+ * of a frame does not depend on the number of samples.
+ */
+struct LodSeries {
+
+    LodSeries(py::handle x, py::handle y, double x0, double dx);
+    ~LodSeries();
+
+    // keep the arrays alive, the worker reads them without the GIL
+    py::array xArray;
+    py::array yArray;
+    PlotArrayInfo pai;
+
+    // levels[k] holds the min and max sample index of every bucket
+    // of LOD_BASE_BUCKET * LOD_BRANCHING^k samples (see implot_ext.cpp)
+    std::vector<std::vector<int>> levels;
+
+    std::atomic<bool> ready{false};
+    std::atomic<bool> cancel{false};
+
+    // unique per series, the data version of queries on it, so a cache
+    // keyed by a buffer address that is reused later does not match
+    int64_t generation = 0;
+
+private:
+
+    std::thread worker;
+};
+
+/**
+ * Retained plot() call.
+ *
+ * Data and style are interpreted once, when the series is created or
+ * changed through setData() and setStyle(). draw() only sets the
+ * pre-parsed style and plots straight from the referenced buffers with
+ * the bounds scanned at creation, so it parses, converts and allocates
+ * nothing. Buffers modified in place need invalidate() (or another
+ * setData()), otherwise the stale bounds and sortedness are used.
+ */
+struct PlotSeries {
+
+    PlotSeries(
+            py::handle x,
+            py::handle y,
+            const std::string& fmt,
+            const std::string& label,
+            py::handle color,
+            float lineWeight,
+            float markerSize,
+            float markerWeight,
+            ImPlotLineFlags flags,
+            bool decimate,
+            double x0,
+            double dx,
+            bool xSorted,
+            py::handle colorValues,
+            py::handle colorIndex,
+            ImPlotColormap colormap,
+            std::optional<double> vmin,
+            std::optional<double> vmax,
+            py::handle palette);
+
+    void setData(py::handle x, py::handle y, double x0, double dx, bool xSorted);
+    void setStyle(const std::string& fmt, py::handle color);
+    void invalidate();
+    void draw();
+
+    std::string label;
+
+    bool line = true;
+    ImPlotMarker marker = ImPlotMarker_None;
+    ImVec4 color;
+    float lineWeight = 1.0f;
+    float markerSize = 4.0f;
+    float markerWeight = 1.0f;
+    ImPlotLineFlags flags = ImPlotLineFlags_None;
+    bool decimate = true;
+
+    // keep the arrays alive, pai points into them
+    py::array xArray;
+    py::array yArray;
+    PlotArrayInfo pai;
+
+    // changes with every setData() and invalidate(), the data version of
+    // queries on the series
+    int64_t generation = 0;
+
+    // per point colors, packed once, null if the series has a single color,
+    // shared so that a frame keeps them while setData() replaces them
+    std::shared_ptr<const std::vector<ImU32>> pointColors;
+
+private:
+
+    // the color arguments, kept to map them again on setData()
+    py::object colorArg;
+    py::object colorValues;
+    py::object colorIndex;
+    py::object palette;
+    ImPlotColormap colormap = IMPLOT_AUTO;
+    // unset limits are taken from the finite values
+    std::optional<double> vmin;
+    std::optional<double> vmax;
+
+    // x_sorted as given, kept for invalidate()
+    bool xSortedArg = false;
+
+    void mapColors();
+};
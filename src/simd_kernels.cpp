@@ -0,0 +1,579 @@
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define KERNELS_TARGET(isa)
+#else
+#define KERNELS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace kernels {
+
+/**
+ * Scalar
+ *
+ * The reference implementations, also used for the tails of the
+ * vectorized kernels. Min and max are written like ImMin / ImMax,
+ * so that NaN samples are culled the same way as in ImPlot.
+ */
+
+static void transformScalar(const double* in, float* out, int count, double pltMin, double m, double pixMin) {
+
+    for (int i = 0; i < count; ++i) {
+        out[i] = (float)(pixMin + m * (in[i] - pltMin));
+    }
+}
+
+static void cullSegmentsScalar(const float* x, const float* y, int count, const float* rect, uint8_t* visible) {
+
+    for (int i = 0; i + 1 < count; ++i) {
+        float minX = x[i] < x[i+1] ? x[i] : x[i+1];
+        float maxX = x[i] >= x[i+1] ? x[i] : x[i+1];
+        float minY = y[i] < y[i+1] ? y[i] : y[i+1];
+        float maxY = y[i] >= y[i+1] ? y[i] : y[i+1];
+        visible[i] = minY < rect[3] && maxY > rect[1] && minX < rect[2] && maxX > rect[0];
+    }
+}
+
+static void segmentNormalsScalar(const float* x, const float* y, int count, float halfWeight, float* nx, float* ny) {
+
+    for (int i = 0; i + 1 < count; ++i) {
+        float dx = x[i+1] - x[i];
+        float dy = y[i+1] - y[i];
+        float d2 = dx * dx + dy * dy;
+        if (d2 > 0.0f) {
+            float invLen = 1.0f / std::sqrt(d2);
+            dx *= invLen;
+            dy *= invLen;
+        }
+        nx[i] = dx * halfWeight;
+        ny[i] = dy * halfWeight;
+    }
+}
+
+static int selectInRectScalar(const double* x, const double* y, int count, const double* rect, int* out) {
+
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        out[n] = i;
+        n += x[i] >= rect[0] && x[i] <= rect[2] && y[i] >= rect[1] && y[i] <= rect[3];
+    }
+    return n;
+}
+
+#if defined(KERNELS_X86)
+
+// expands the lowest 4 bits of mask to one byte each
+static inline void storeMask4(uint8_t* dst, unsigned int mask) {
+
+    uint32_t bytes = ((mask & 0xf) * 0x00204081u) & 0x01010101u;
+    memcpy(dst, &bytes, 4);
+}
+
+/**
+ * SSE4.1
+ */
+
+KERNELS_TARGET("sse4.1")
+static void transformSSE41(const double* in, float* out, int count, double pltMin, double m, double pixMin) {
+
+    const __m128d vPltMin = _mm_set1_pd(pltMin);
+    const __m128d vM = _mm_set1_pd(m);
+    const __m128d vPixMin = _mm_set1_pd(pixMin);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd(in + i);
+        __m128d b = _mm_loadu_pd(in + i + 2);
+        __m128 lo = _mm_cvtpd_ps(_mm_add_pd(vPixMin, _mm_mul_pd(vM, _mm_sub_pd(a, vPltMin))));
+        __m128 hi = _mm_cvtpd_ps(_mm_add_pd(vPixMin, _mm_mul_pd(vM, _mm_sub_pd(b, vPltMin))));
+        _mm_storeu_ps(out + i, _mm_movelh_ps(lo, hi));
+    }
+
+    transformScalar(in + i, out + i, count - i, pltMin, m, pixMin);
+}
+
+KERNELS_TARGET("sse4.1")
+static void cullSegmentsSSE41(const float* x, const float* y, int count, const float* rect, uint8_t* visible) {
+
+    const __m128 rMinX = _mm_set1_ps(rect[0]);
+    const __m128 rMinY = _mm_set1_ps(rect[1]);
+    const __m128 rMaxX = _mm_set1_ps(rect[2]);
+    const __m128 rMaxY = _mm_set1_ps(rect[3]);
+
+    int i = 0;
+    for (; i + 5 <= count; i += 4) {
+        __m128 x0 = _mm_loadu_ps(x + i);
+        __m128 x1 = _mm_loadu_ps(x + i + 1);
+        __m128 y0 = _mm_loadu_ps(y + i);
+        __m128 y1 = _mm_loadu_ps(y + i + 1);
+        __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmplt_ps(_mm_min_ps(y0, y1), rMaxY),
+                           _mm_cmpgt_ps(_mm_max_ps(y0, y1), rMinY)),
+                _mm_and_ps(_mm_cmplt_ps(_mm_min_ps(x0, x1), rMaxX),
+                           _mm_cmpgt_ps(_mm_max_ps(x0, x1), rMinX)));
+        storeMask4(visible + i, (unsigned int)_mm_movemask_ps(inside));
+    }
+
+    cullSegmentsScalar(x + i, y + i, count - i, rect, visible + i);
+}
+
+KERNELS_TARGET("sse4.1")
+static void segmentNormalsSSE41(const float* x, const float* y, int count, float halfWeight, float* nx, float* ny) {
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 hw = _mm_set1_ps(halfWeight);
+
+    int i = 0;
+    for (; i + 5 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i + 1), _mm_loadu_ps(x + i));
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i + 1), _mm_loadu_ps(y + i));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 invLen = _mm_blendv_ps(one, _mm_div_ps(one, _mm_sqrt_ps(d2)), _mm_cmpgt_ps(d2, zero));
+        _mm_storeu_ps(nx + i, _mm_mul_ps(_mm_mul_ps(dx, invLen), hw));
+        _mm_storeu_ps(ny + i, _mm_mul_ps(_mm_mul_ps(dy, invLen), hw));
+    }
+
+    segmentNormalsScalar(x + i, y + i, count - i, halfWeight, nx + i, ny + i);
+}
+
+KERNELS_TARGET("sse4.1")
+static int selectInRectSSE41(const double* x, const double* y, int count, const double* rect, int* out) {
+
+    const __m128d rMinX = _mm_set1_pd(rect[0]);
+    const __m128d rMinY = _mm_set1_pd(rect[1]);
+    const __m128d rMaxX = _mm_set1_pd(rect[2]);
+    const __m128d rMaxY = _mm_set1_pd(rect[3]);
+
+    int n = 0;
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d vx = _mm_loadu_pd(x + i);
+        __m128d vy = _mm_loadu_pd(y + i);
+        __m128d inside = _mm_and_pd(
+                _mm_and_pd(_mm_cmpge_pd(vx, rMinX), _mm_cmple_pd(vx, rMaxX)),
+                _mm_and_pd(_mm_cmpge_pd(vy, rMinY), _mm_cmple_pd(vy, rMaxY)));
+        const int mask = _mm_movemask_pd(inside);
+        out[n] = i;
+        n += mask & 1;
+        out[n] = i + 1;
+        n += (mask >> 1) & 1;
+    }
+
+    int tail = selectInRectScalar(x + i, y + i, count - i, rect, out + n);
+    for (int k = n; k < n + tail; ++k) {
+        out[k] += i;
+    }
+    return n + tail;
+}
+
+/**
+ * AVX2
+ */
+
+KERNELS_TARGET("avx2")
+static void transformAVX2(const double* in, float* out, int count, double pltMin, double m, double pixMin) {
+
+    const __m256d vPltMin = _mm256_set1_pd(pltMin);
+    const __m256d vM = _mm256_set1_pd(m);
+    const __m256d vPixMin = _mm256_set1_pd(pixMin);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(in + i);
+        __m256d b = _mm256_loadu_pd(in + i + 4);
+        __m128 lo = _mm256_cvtpd_ps(_mm256_add_pd(vPixMin, _mm256_mul_pd(vM, _mm256_sub_pd(a, vPltMin))));
+        __m128 hi = _mm256_cvtpd_ps(_mm256_add_pd(vPixMin, _mm256_mul_pd(vM, _mm256_sub_pd(b, vPltMin))));
+        _mm256_storeu_ps(out + i, _mm256_set_m128(hi, lo));
+    }
+
+    transformScalar(in + i, out + i, count - i, pltMin, m, pixMin);
+}
+
+KERNELS_TARGET("avx2")
+static void cullSegmentsAVX2(const float* x, const float* y, int count, const float* rect, uint8_t* visible) {
+
+    const __m256 rMinX = _mm256_set1_ps(rect[0]);
+    const __m256 rMinY = _mm256_set1_ps(rect[1]);
+    const __m256 rMaxX = _mm256_set1_ps(rect[2]);
+    const __m256 rMaxY = _mm256_set1_ps(rect[3]);
+
+    int i = 0;
+    for (; i + 9 <= count; i += 8) {
+        __m256 x0 = _mm256_loadu_ps(x + i);
+        __m256 x1 = _mm256_loadu_ps(x + i + 1);
+        __m256 y0 = _mm256_loadu_ps(y + i);
+        __m256 y1 = _mm256_loadu_ps(y + i + 1);
+        __m256 inside = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(y0, y1), rMaxY, _CMP_LT_OQ),
+                              _mm256_cmp_ps(_mm256_max_ps(y0, y1), rMinY, _CMP_GT_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(x0, x1), rMaxX, _CMP_LT_OQ),
+                              _mm256_cmp_ps(_mm256_max_ps(x0, x1), rMinX, _CMP_GT_OQ)));
+        unsigned int mask = (unsigned int)_mm256_movemask_ps(inside);
+        storeMask4(visible + i, mask);
+        storeMask4(visible + i + 4, mask >> 4);
+    }
+
+    cullSegmentsScalar(x + i, y + i, count - i, rect, visible + i);
+}
+
+KERNELS_TARGET("avx2")
+static void segmentNormalsAVX2(const float* x, const float* y, int count, float halfWeight, float* nx, float* ny) {
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 hw = _mm256_set1_ps(halfWeight);
+
+    int i = 0;
+    for (; i + 9 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i + 1), _mm256_loadu_ps(x + i));
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i + 1), _mm256_loadu_ps(y + i));
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 invLen = _mm256_blendv_ps(one,
+                _mm256_div_ps(one, _mm256_sqrt_ps(d2)),
+                _mm256_cmp_ps(d2, zero, _CMP_GT_OQ));
+        _mm256_storeu_ps(nx + i, _mm256_mul_ps(_mm256_mul_ps(dx, invLen), hw));
+        _mm256_storeu_ps(ny + i, _mm256_mul_ps(_mm256_mul_ps(dy, invLen), hw));
+    }
+
+    segmentNormalsScalar(x + i, y + i, count - i, halfWeight, nx + i, ny + i);
+}
+
+KERNELS_TARGET("avx2")
+static int selectInRectAVX2(const double* x, const double* y, int count, const double* rect, int* out) {
+
+    const __m256d rMinX = _mm256_set1_pd(rect[0]);
+    const __m256d rMinY = _mm256_set1_pd(rect[1]);
+    const __m256d rMaxX = _mm256_set1_pd(rect[2]);
+    const __m256d rMaxY = _mm256_set1_pd(rect[3]);
+
+    int n = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d vy = _mm256_loadu_pd(y + i);
+        __m256d inside = _mm256_and_pd(
+                _mm256_and_pd(_mm256_cmp_pd(vx, rMinX, _CMP_GE_OQ), _mm256_cmp_pd(vx, rMaxX, _CMP_LE_OQ)),
+                _mm256_and_pd(_mm256_cmp_pd(vy, rMinY, _CMP_GE_OQ), _mm256_cmp_pd(vy, rMaxY, _CMP_LE_OQ)));
+        const int mask = _mm256_movemask_pd(inside);
+        if (mask == 0) {
+            continue;
+        }
+        for (int k = 0; k < 4; ++k) {
+            out[n] = i + k;
+            n += (mask >> k) & 1;
+        }
+    }
+
+    int tail = selectInRectScalar(x + i, y + i, count - i, rect, out + n);
+    for (int k = n; k < n + tail; ++k) {
+        out[k] += i;
+    }
+    return n + tail;
+}
+
+/**
+ * AVX-512
+ */
+
+// some gcc versions warn about the undefined operands inside their own intrinsics
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+KERNELS_TARGET("avx512f")
+static void transformAVX512(const double* in, float* out, int count, double pltMin, double m, double pixMin) {
+
+    const __m512d vPltMin = _mm512_set1_pd(pltMin);
+    const __m512d vM = _mm512_set1_pd(m);
+    const __m512d vPixMin = _mm512_set1_pd(pixMin);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512d a = _mm512_loadu_pd(in + i);
+        __m512d b = _mm512_loadu_pd(in + i + 8);
+        _mm256_storeu_ps(out + i, _mm512_cvtpd_ps(_mm512_add_pd(vPixMin, _mm512_mul_pd(vM, _mm512_sub_pd(a, vPltMin)))));
+        _mm256_storeu_ps(out + i + 8, _mm512_cvtpd_ps(_mm512_add_pd(vPixMin, _mm512_mul_pd(vM, _mm512_sub_pd(b, vPltMin)))));
+    }
+
+    transformScalar(in + i, out + i, count - i, pltMin, m, pixMin);
+}
+
+KERNELS_TARGET("avx512f")
+static void cullSegmentsAVX512(const float* x, const float* y, int count, const float* rect, uint8_t* visible) {
+
+    const __m512 rMinX = _mm512_set1_ps(rect[0]);
+    const __m512 rMinY = _mm512_set1_ps(rect[1]);
+    const __m512 rMaxX = _mm512_set1_ps(rect[2]);
+    const __m512 rMaxY = _mm512_set1_ps(rect[3]);
+    const __m512i ones = _mm512_set1_epi32(1);
+
+    int i = 0;
+    for (; i + 17 <= count; i += 16) {
+        __m512 x0 = _mm512_loadu_ps(x + i);
+        __m512 x1 = _mm512_loadu_ps(x + i + 1);
+        __m512 y0 = _mm512_loadu_ps(y + i);
+        __m512 y1 = _mm512_loadu_ps(y + i + 1);
+        __mmask16 inside = _mm512_cmp_ps_mask(_mm512_min_ps(y0, y1), rMaxY, _CMP_LT_OQ);
+        inside = _mm512_mask_cmp_ps_mask(inside, _mm512_max_ps(y0, y1), rMinY, _CMP_GT_OQ);
+        inside = _mm512_mask_cmp_ps_mask(inside, _mm512_min_ps(x0, x1), rMaxX, _CMP_LT_OQ);
+        inside = _mm512_mask_cmp_ps_mask(inside, _mm512_max_ps(x0, x1), rMinX, _CMP_GT_OQ);
+        _mm_storeu_si128((__m128i*)(visible + i), _mm512_cvtepi32_epi8(_mm512_maskz_mov_epi32(inside, ones)));
+    }
+
+    cullSegmentsScalar(x + i, y + i, count - i, rect, visible + i);
+}
+
+KERNELS_TARGET("avx512f")
+static void segmentNormalsAVX512(const float* x, const float* y, int count, float halfWeight, float* nx, float* ny) {
+
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 hw = _mm512_set1_ps(halfWeight);
+
+    int i = 0;
+    for (; i + 17 <= count; i += 16) {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + i + 1), _mm512_loadu_ps(x + i));
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + i + 1), _mm512_loadu_ps(y + i));
+        __m512 d2 = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+        __mmask16 positive = _mm512_cmp_ps_mask(d2, zero, _CMP_GT_OQ);
+        __m512 invLen = _mm512_mask_div_ps(one, positive, one, _mm512_sqrt_ps(d2));
+        _mm512_storeu_ps(nx + i, _mm512_mul_ps(_mm512_mul_ps(dx, invLen), hw));
+        _mm512_storeu_ps(ny + i, _mm512_mul_ps(_mm512_mul_ps(dy, invLen), hw));
+    }
+
+    segmentNormalsScalar(x + i, y + i, count - i, halfWeight, nx + i, ny + i);
+}
+
+KERNELS_TARGET("avx512f")
+static int selectInRectAVX512(const double* x, const double* y, int count, const double* rect, int* out) {
+
+    const __m512d rMinX = _mm512_set1_pd(rect[0]);
+    const __m512d rMinY = _mm512_set1_pd(rect[1]);
+    const __m512d rMaxX = _mm512_set1_pd(rect[2]);
+    const __m512d rMaxY = _mm512_set1_pd(rect[3]);
+
+    int n = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d vx = _mm512_loadu_pd(x + i);
+        __m512d vy = _mm512_loadu_pd(y + i);
+        __mmask8 inside = _mm512_cmp_pd_mask(vx, rMinX, _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, vx, rMaxX, _CMP_LE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, vy, rMinY, _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, vy, rMaxY, _CMP_LE_OQ);
+        const int mask = (int)inside;
+        if (mask == 0) {
+            continue;
+        }
+        for (int k = 0; k < 8; ++k) {
+            out[n] = i + k;
+            n += (mask >> k) & 1;
+        }
+    }
+
+    int tail = selectInRectScalar(x + i, y + i, count - i, rect, out + n);
+    for (int k = n; k < n + tail; ++k) {
+        out[k] += i;
+    }
+    return n + tail;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+/**
+ * Dispatch
+ */
+
+struct Table {
+    void (*transform)(const double*, float*, int, double, double, double);
+    void (*cullSegments)(const float*, const float*, int, const float*, uint8_t*);
+    void (*segmentNormals)(const float*, const float*, int, float, float*, float*);
+    int (*selectInRect)(const double*, const double*, int, const double*, int*);
+};
+
+static const Table tables[] = {
+    { transformScalar, cullSegmentsScalar, segmentNormalsScalar, selectInRectScalar },
+#if defined(KERNELS_X86)
+    { transformSSE41, cullSegmentsSSE41, segmentNormalsSSE41, selectInRectSSE41 },
+    { transformAVX2, cullSegmentsAVX2, segmentNormalsAVX2, selectInRectAVX2 },
+    { transformAVX512, cullSegmentsAVX512, segmentNormalsAVX512, selectInRectAVX512 },
+#endif
+};
+
+Isa detectIsa() {
+
+#if defined(KERNELS_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // the os has to save the ymm / zmm registers as well
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool ymm = (xcr0 & 0x6) == 0x6;
+    const bool zmm = (xcr0 & 0xe6) == 0xe6;
+
+    bool avx2 = false;
+    bool avx512 = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = avx && ymm && (info[1] & (1 << 5)) != 0;
+        avx512 = avx2 && zmm && (info[1] & (1 << 16)) != 0;
+    }
+
+    if (avx512) {
+        return Isa_AVX512;
+    }
+    if (avx2) {
+        return Isa_AVX2;
+    }
+    if (sse41) {
+        return Isa_SSE41;
+    }
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return Isa_SSE41;
+    }
+#endif
+#endif
+
+    return Isa_Scalar;
+}
+
+const char* isaName(Isa isa) {
+
+    switch (isa) {
+        case Isa_SSE41: return "sse4.1";
+        case Isa_AVX2: return "avx2";
+        case Isa_AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+static std::atomic<int>& activeIsa() {
+
+    static std::atomic<int> isa{(int)detectIsa()};
+    return isa;
+}
+
+static const Table& table() {
+
+    return tables[activeIsa().load(std::memory_order_relaxed)];
+}
+
+void setIsa(Isa isa) {
+
+    activeIsa() = (int)std::max(Isa_Scalar, std::min(isa, detectIsa()));
+}
+
+Isa currentIsa() {
+
+    return (Isa)activeIsa().load();
+}
+
+void transform(const double* in, float* out, int count, double pltMin, double m, double pixMin) {
+
+    table().transform(in, out, count, pltMin, m, pixMin);
+}
+
+void cullSegments(const float* x, const float* y, int count, const float* rect, uint8_t* visible) {
+
+    table().cullSegments(x, y, count, rect, visible);
+}
+
+void segmentNormals(const float* x, const float* y, int count, float halfWeight, float* nx, float* ny) {
+
+    table().segmentNormals(x, y, count, halfWeight, nx, ny);
+}
+
+int selectInRect(const double* x, const double* y, int count, const double* rect, int* out) {
+
+    return table().selectInRect(x, y, count, rect, out);
+}
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+std::vector<std::pair<std::string, double>> benchmark(int count, int repeat) {
+
+    count = std::max(count, 2);
+    repeat = std::max(repeat, 1);
+
+    // a random walk, roughly half of it inside the plot
+    std::mt19937 rng(42);
+    std::normal_distribution<double> step(0.0, 1.0);
+
+    std::vector<double> xs(count);
+    std::vector<double> ys(count);
+    double y = 0.0;
+    for (int i = 0; i < count; ++i) {
+        xs[i] = (double)i;
+        ys[i] = y;
+        y += step(rng);
+    }
+
+    std::vector<float> px(count);
+    std::vector<float> py(count);
+    std::vector<float> nx(count);
+    std::vector<float> ny(count);
+    std::vector<uint8_t> visible(count);
+
+    const float rect[4] = {0.0f, 0.0f, 1920.0f, 1080.0f};
+    const double m = 2.0 * rect[2] / count;
+
+    const Isa previous = currentIsa();
+    std::vector<std::pair<std::string, double>> results;
+
+    for (int isa = Isa_Scalar; isa <= (int)detectIsa(); ++isa) {
+
+        setIsa((Isa)isa);
+
+        double best = HUGE_VAL;
+        for (int r = 0; r < repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            transform(xs.data(), px.data(), count, 0.0, m, 0.0);
+            transform(ys.data(), py.data(), count, -100.0, 5.0, 0.0);
+            cullSegments(px.data(), py.data(), count, rect, visible.data());
+            segmentNormals(px.data(), py.data(), count, 1.0f, nx.data(), ny.data());
+            std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+            best = std::min(best, dt.count());
+        }
+
+        results.emplace_back(isaName((Isa)isa), count / std::max(best, 1e-9));
+    }
+
+    setIsa(previous);
+
+    return results;
+}
+#endif
+}
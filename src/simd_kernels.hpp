@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Batch kernels for the hot loops of line rendering and selection.
+ *
+ * Every kernel has a scalar, an SSE4.1, an AVX2 and an AVX-512 variant.
+ * The best variant supported by the cpu is selected once at runtime, so
+ * the module does not have to be compiled for a specific instruction set.
+ */
+namespace kernels {
+
+enum Isa {
+    Isa_Scalar,
+    Isa_SSE41,
+    Isa_AVX2,
+    Isa_AVX512
+};
+
+// highest instruction set supported by the cpu (and this build)
+Isa detectIsa();
+const char* isaName(Isa isa);
+
+// selects the kernel variants, requests above detectIsa() are clamped
+void setIsa(Isa isa);
+Isa currentIsa();
+
+// out[i] = (float)(pixMin + m * (in[i] - pltMin)), same as ImPlot's Transformer1
+void transform(const double* in, float* out, int count, double pltMin, double m, double pixMin);
+
+// visible[i] = segment (i, i + 1) overlaps rect {min x, min y, max x, max y},
+// for i in [0, count - 1), same test as ImPlot's line strip renderer
+void cullSegments(const float* x, const float* y, int count, const float* rect, uint8_t* visible);
+
+// (nx[i], ny[i]) = direction of segment (i, i + 1) with length halfWeight,
+// for i in [0, count - 1), zero length segments keep a zero direction
+void segmentNormals(const float* x, const float* y, int count, float halfWeight, float* nx, float* ny);
+
+// writes the indices i in [0, count) with rect[0] <= x[i] <= rect[2] and
+// rect[1] <= y[i] <= rect[3] to out in ascending order, returns their number,
+// out needs room for count indices
+int selectInRect(const double* x, const double* y, int count, const double* rect, int* out);
+
+#ifdef IMVIZ_BENCHMARK_HOOKS
+// runs the line kernels over count random samples for every supported
+// instruction set and returns the throughput in points per second
+std::vector<std::pair<std::string, double>> benchmark(int count, int repeat);
+#endif
+}